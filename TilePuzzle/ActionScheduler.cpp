@@ -0,0 +1,183 @@
+#include "ActionScheduler.h"
+#include <algorithm>
+#include <new>
+#include "GameBoard.h"
+
+CoroutineFramePool& CoroutineFramePool::getInstance()
+{
+    static CoroutineFramePool instance;
+    return instance;
+}
+
+size_t CoroutineFramePool::getSizeClass(const size_t size)
+{
+    return static_cast<size_t>(std::lower_bound(SIZE_CLASSES.begin(), SIZE_CLASSES.end(), size) - SIZE_CLASSES.begin());
+}
+
+void* CoroutineFramePool::allocate(const size_t size)
+{
+    ++m_statistics.liveFrames;
+    const size_t sizeClass = getSizeClass(size);
+    if (sizeClass == SIZE_CLASSES.size())
+    {
+        ++m_statistics.heapFrames;
+        return ::operator new(size);
+    }
+
+    if (!m_free[sizeClass])
+    {
+        // operator new[] aligns to __STDCPP_DEFAULT_NEW_ALIGNMENT__, and every class is a multiple of it
+        const size_t frameSize = SIZE_CLASSES[sizeClass];
+        m_chunks.push_back(std::make_unique<std::byte[]>(frameSize * FRAMES_PER_CHUNK));
+        ++m_statistics.chunks;
+        std::byte* chunk = m_chunks.back().get();
+        for (size_t i = FRAMES_PER_CHUNK; i-- > 0;)
+            m_free[sizeClass] = new (chunk + i * frameSize) FreeFrame{ m_free[sizeClass] };
+    }
+
+    FreeFrame* frame = m_free[sizeClass];
+    m_free[sizeClass] = frame->next;
+    return frame;
+}
+
+void CoroutineFramePool::deallocate(void* frame, const size_t size)
+{
+    --m_statistics.liveFrames;
+    const size_t sizeClass = getSizeClass(size);
+    if (sizeClass == SIZE_CLASSES.size())
+    {
+        --m_statistics.heapFrames;
+        ::operator delete(frame);
+        return;
+    }
+
+    m_free[sizeClass] = new (frame) FreeFrame{ m_free[sizeClass] };
+}
+
+ActionTask& ActionTask::operator=(ActionTask&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_handle)
+            m_handle.destroy();
+        m_handle = other.m_handle;
+        other.m_handle = nullptr;
+    }
+    return *this;
+}
+
+ActionTask::~ActionTask()
+{
+    if (m_handle)
+        m_handle.destroy();
+}
+
+ActionTask::Handle ActionTask::release()
+{
+    const Handle handle = m_handle;
+    m_handle = nullptr;
+    return handle;
+}
+
+ActionScheduler::TaskId ActionScheduler::start(ActionTask task)
+{
+    const ActionTask::Handle handle = task.release();
+    handle.resume();
+    if (handle.done())
+    {
+        const std::exception_ptr exception = handle.promise().exception;
+        handle.destroy();
+        if (exception)
+            std::rethrow_exception(exception);
+        return 0;
+    }
+
+    const TaskId id = m_nextId++;
+    if (m_nextId == 0)
+        m_nextId = 1;
+    m_tasks.push_back({ handle, id });
+    return id;
+}
+
+void ActionScheduler::update(const double deltaTime)
+{
+    std::exception_ptr firstException;
+    const size_t count = m_tasks.size();
+    size_t kept = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        // Copied: resuming may start tasks and grow the vector
+        const Entry entry = m_tasks[i];
+        if (!entry.handle)
+            continue;
+
+        if (isReady(entry.handle.promise().wait, deltaTime))
+        {
+            entry.handle.promise().wait = {};
+            entry.handle.resume();
+            if (entry.handle.done())
+            {
+                if (entry.handle.promise().exception && !firstException)
+                    firstException = entry.handle.promise().exception;
+                entry.handle.destroy();
+                continue;
+            }
+        }
+        m_tasks[kept++] = entry;
+    }
+
+    // Tasks started during the update are kept after the survivors
+    m_tasks.erase(m_tasks.begin() + static_cast<std::ptrdiff_t>(kept), m_tasks.begin() + static_cast<std::ptrdiff_t>(count));
+    if (firstException)
+        std::rethrow_exception(firstException);
+}
+
+bool ActionScheduler::cancel(const TaskId task)
+{
+    for (Entry& entry : m_tasks)
+    {
+        if (entry.id == task && entry.handle)
+        {
+            entry.handle.destroy();
+            entry.handle = nullptr;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ActionScheduler::clear()
+{
+    for (const Entry& entry : m_tasks)
+    {
+        if (entry.handle)
+            entry.handle.destroy();
+    }
+    m_tasks.clear();
+}
+
+bool ActionScheduler::isRunning(const TaskId task) const
+{
+    return task != 0 && std::any_of(m_tasks.begin(), m_tasks.end(),
+        [task](const Entry& entry) { return entry.id == task && entry.handle; });
+}
+
+bool ActionScheduler::isReady(ActionWait& wait, const double deltaTime)
+{
+    switch (wait.kind)
+    {
+    case ActionWait::Kind::Steps:
+        return wait.steps == 0 || --wait.steps == 0;
+    case ActionWait::Kind::Seconds:
+        wait.seconds -= deltaTime;
+        return wait.seconds <= 0;
+    case ActionWait::Kind::Walk:
+    {
+        const std::shared_ptr<const GameObject> walker = wait.walker.lock();
+        return !walker || walker->getRemainingCheckpoints() == 0;
+    }
+    case ActionWait::Kind::None:
+    default:
+        return true;
+    }
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <vector>
+
+class GameObject;
+
+/**
+ * @brief Free lists of coroutine frames in a few size classes, carved from chunks that are kept for
+ * the process lifetime. A finished sequence's frame is reused by the next one of similar size, so
+ * starting sequences stops allocating once the pool has grown to the peak count. Main thread only;
+ * frames larger than the largest class come from the global heap.
+ */
+class CoroutineFramePool
+{
+public:
+    static constexpr std::array<size_t, 4> SIZE_CLASSES = { 128, 256, 512, 1024 };
+    static constexpr size_t FRAMES_PER_CHUNK = 64;
+
+    struct Statistics
+    {
+        size_t chunks{};
+        size_t liveFrames{};
+        size_t heapFrames{};        // Live frames too large for any class
+    };
+
+    static CoroutineFramePool& getInstance();
+
+    void* allocate(size_t size);
+    void deallocate(void* frame, size_t size);
+    [[nodiscard]] const Statistics& getStatistics() const { return m_statistics; }
+
+    CoroutineFramePool(const CoroutineFramePool&) = delete;
+    CoroutineFramePool& operator=(const CoroutineFramePool&) = delete;
+
+private:
+    CoroutineFramePool() = default;
+
+    struct FreeFrame
+    {
+        FreeFrame* next;
+    };
+
+    [[nodiscard]] static size_t getSizeClass(size_t size);
+
+    std::array<FreeFrame*, SIZE_CLASSES.size()> m_free{};
+    std::vector<std::unique_ptr<std::byte[]>> m_chunks;
+    Statistics m_statistics;
+};
+
+/**
+ * @brief What a suspended sequence is waiting for; ActionScheduler polls it every update.
+ */
+struct ActionWait
+{
+    enum class Kind : uint8_t
+    {
+        None = 0,
+        Steps,
+        Seconds,
+        Walk
+    };
+
+    Kind kind = Kind::None;
+    uint32_t steps{};
+    double seconds{};
+    std::weak_ptr<const GameObject> walker{};
+};
+
+/**
+ * @brief Coroutine that sequences actions across updates, e.g. walk to a block, push it, wait for the slide.
+ * Created suspended and owned by whoever holds it until handed to ActionScheduler::start.
+ * Frames come from CoroutineFramePool, so thousands of live sequences don't touch the heap per update.
+ */
+class ActionTask
+{
+public:
+    struct promise_type
+    {
+        ActionTask get_return_object() { return ActionTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { exception = std::current_exception(); }
+
+        static void* operator new(const size_t size) { return CoroutineFramePool::getInstance().allocate(size); }
+        static void operator delete(void* frame, const size_t size) { CoroutineFramePool::getInstance().deallocate(frame, size); }
+
+        ActionWait wait;
+        std::exception_ptr exception;
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+
+    ActionTask(ActionTask&& other) noexcept : m_handle(other.m_handle) { other.m_handle = nullptr; }
+    ActionTask& operator=(ActionTask&& other) noexcept;
+    ~ActionTask();
+
+    ActionTask(const ActionTask&) = delete;
+    ActionTask& operator=(const ActionTask&) = delete;
+
+    /**
+     * @brief Gives up ownership of the frame.
+     */
+    Handle release();
+
+private:
+    explicit ActionTask(const Handle handle) : m_handle(handle) {}
+
+    Handle m_handle;
+};
+
+/**
+ * @brief Suspends the calling ActionTask until its wait is over. Obtained from the functions below.
+ */
+struct ActionAwaiter
+{
+    ActionWait wait;
+
+    [[nodiscard]] bool await_ready() const noexcept { return false; }
+    void await_suspend(const ActionTask::Handle handle) { handle.promise().wait = std::move(wait); }
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Resumes after the given number of scheduler updates (fixed steps).
+ */
+[[nodiscard]] inline ActionAwaiter waitSteps(const uint32_t steps = 1) { return { { .kind = ActionWait::Kind::Steps, .steps = steps } }; }
+[[nodiscard]] inline ActionAwaiter waitSeconds(const double seconds) { return { { .kind = ActionWait::Kind::Seconds, .seconds = seconds } }; }
+
+/**
+ * @brief Resumes once the object has no checkpoints left, or is gone.
+ */
+[[nodiscard]] inline ActionAwaiter waitForWalk(const std::shared_ptr<const GameObject>& walker)
+{
+    return { { .kind = ActionWait::Kind::Walk, .walker = walker } };
+}
+
+/**
+ * @brief Runs ActionTasks, resuming each once what it waits for is over. Driven from the fixed update.
+ */
+class ActionScheduler
+{
+public:
+    using TaskId = uint32_t;    // 0 is never issued
+
+    ActionScheduler() = default;
+    ~ActionScheduler() { clear(); }
+
+    ActionScheduler(const ActionScheduler&) = delete;
+    ActionScheduler& operator=(const ActionScheduler&) = delete;
+
+    /**
+     * @brief Takes the task and runs it up to its first suspension.
+     * @throws whatever the task throws before suspending; the task is discarded
+     */
+    TaskId start(ActionTask task);
+
+    /**
+     * @brief Resumes every task whose wait is over. Tasks started meanwhile are first polled next update.
+     * @throws the first exception a task let escape, after every task was polled; that task is discarded
+     */
+    void update(double deltaTime);
+
+    /**
+     * @brief Destroys the task where it is suspended. Not for a task to cancel itself.
+     * @return false if it had finished already
+     */
+    bool cancel(TaskId task);
+    void clear();
+
+    [[nodiscard]] bool isRunning(TaskId task) const;
+    [[nodiscard]] size_t getActiveCount() const { return m_tasks.size(); }
+    void reserve(const size_t tasks) { m_tasks.reserve(tasks); }
+
+private:
+    struct Entry
+    {
+        ActionTask::Handle handle;  // Null once cancelled, dropped by the next update
+        TaskId id{};
+    };
+
+    [[nodiscard]] static bool isReady(ActionWait& wait, double deltaTime);
+
+    std::vector<Entry> m_tasks;
+    TaskId m_nextId = 1;
+};
@@ -0,0 +1,222 @@
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <SDL.h>
+
+namespace
+{
+    constexpr const char* CATEGORY_NAMES[AllocationTracker::CATEGORY_COUNT] =
+    {
+        "other", "input", "board update", "modifiers", "render", "pathfinding"
+    };
+
+    // Constant-initialized, so they are usable by allocations made before main
+    std::atomic<uint64_t> g_counts[AllocationTracker::CATEGORY_COUNT]{};
+    std::atomic<uint64_t> g_bytes[AllocationTracker::CATEGORY_COUNT]{};
+    std::atomic<uint64_t> g_frees{ 0 };
+    std::atomic<uint64_t> g_mainThreadCount{ 0 };
+    thread_local bool g_isMainThread = false;
+
+    AllocationTracker::Frame readCounters()
+    {
+        AllocationTracker::Frame frame;
+        for (size_t i = 0; i < AllocationTracker::CATEGORY_COUNT; ++i)
+        {
+            frame.categories[i].count = g_counts[i].load(std::memory_order_relaxed);
+            frame.categories[i].bytes = g_bytes[i].load(std::memory_order_relaxed);
+        }
+        frame.frees = g_frees.load(std::memory_order_relaxed);
+        frame.mainThreadCount = g_mainThreadCount.load(std::memory_order_relaxed);
+        return frame;
+    }
+
+    uint64_t countOf(const AllocationTracker::Frame& frame)
+    {
+        uint64_t count = 0;
+        for (const auto& category : frame.categories)
+            count += category.count;
+        return count;
+    }
+
+#ifdef TILEPUZZLE_TRACK_ALLOCATIONS
+    SDL_malloc_func g_sdlMalloc;
+    SDL_calloc_func g_sdlCalloc;
+    SDL_realloc_func g_sdlRealloc;
+    SDL_free_func g_sdlFree;
+
+    void* SDLCALL trackedMalloc(const size_t size)
+    {
+        AllocationTracker::recordAllocation(size);
+        return g_sdlMalloc(size);
+    }
+
+    void* SDLCALL trackedCalloc(const size_t count, const size_t size)
+    {
+        AllocationTracker::recordAllocation(count * size);
+        return g_sdlCalloc(count, size);
+    }
+
+    void* SDLCALL trackedRealloc(void* memory, const size_t size)
+    {
+        AllocationTracker::recordAllocation(size);
+        return g_sdlRealloc(memory, size);
+    }
+
+    void SDLCALL trackedFree(void* memory)
+    {
+        if (memory)
+            AllocationTracker::recordFree();
+        g_sdlFree(memory);
+    }
+
+    void* allocate(const size_t size)
+    {
+        AllocationTracker::recordAllocation(size);
+        if (void* memory = std::malloc(size ? size : 1))
+            return memory;
+        throw std::bad_alloc();
+    }
+
+    void* allocateAligned(const size_t size, const std::align_val_t alignment)
+    {
+        AllocationTracker::recordAllocation(size);
+#ifdef _MSC_VER
+        if (void* memory = _aligned_malloc(size ? size : 1, static_cast<size_t>(alignment)))
+            return memory;
+#else
+        void* memory = nullptr;
+        if (posix_memalign(&memory, std::max(sizeof(void*), static_cast<size_t>(alignment)), size ? size : 1) == 0)
+            return memory;
+#endif
+        throw std::bad_alloc();
+    }
+
+    void deallocate(void* memory) noexcept
+    {
+        if (!memory)
+            return;
+        AllocationTracker::recordFree();
+        std::free(memory);
+    }
+
+    void deallocateAligned(void* memory) noexcept
+    {
+        if (!memory)
+            return;
+        AllocationTracker::recordFree();
+#ifdef _MSC_VER
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+#endif
+}
+
+thread_local AllocationCategory AllocationTracker::s_category = AllocationCategory::Other;
+thread_local bool AllocationTracker::s_expected = false;
+bool AllocationTracker::s_assertSteadyState = false;
+AllocationTracker::Frame AllocationTracker::s_lastFrame;
+AllocationTracker::Frame AllocationTracker::s_frameStart;
+AllocationTracker::Frame AllocationTracker::s_peakFrame;
+AllocationTracker::Counters AllocationTracker::s_total;
+uint64_t AllocationTracker::s_frames = 0;
+
+void AllocationTracker::install()
+{
+    g_isMainThread = true;
+#ifdef TILEPUZZLE_TRACK_ALLOCATIONS
+    SDL_GetMemoryFunctions(&g_sdlMalloc, &g_sdlCalloc, &g_sdlRealloc, &g_sdlFree);
+    SDL_SetMemoryFunctions(trackedMalloc, trackedCalloc, trackedRealloc, trackedFree);
+#endif
+}
+
+void AllocationTracker::recordAllocation(const size_t bytes) noexcept
+{
+    const auto category = static_cast<size_t>(s_category);
+    g_counts[category].fetch_add(1, std::memory_order_relaxed);
+    g_bytes[category].fetch_add(bytes, std::memory_order_relaxed);
+    if (g_isMainThread && !s_expected)
+        g_mainThreadCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AllocationTracker::recordFree() noexcept
+{
+    g_frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AllocationTracker::beginFrame()
+{
+    s_frameStart = readCounters();
+}
+
+void AllocationTracker::endFrame(const bool steady)
+{
+    const Frame now = readCounters();
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i)
+    {
+        s_lastFrame.categories[i].count = now.categories[i].count - s_frameStart.categories[i].count;
+        s_lastFrame.categories[i].bytes = now.categories[i].bytes - s_frameStart.categories[i].bytes;
+        s_total.count += s_lastFrame.categories[i].count;
+        s_total.bytes += s_lastFrame.categories[i].bytes;
+    }
+    s_lastFrame.frees = now.frees - s_frameStart.frees;
+    s_lastFrame.mainThreadCount = now.mainThreadCount - s_frameStart.mainThreadCount;
+    ++s_frames;
+
+    if (countOf(s_lastFrame) > countOf(s_peakFrame))
+        s_peakFrame = s_lastFrame;
+
+    if (ENABLED && s_assertSteadyState && steady && s_frames > WARMUP_FRAMES && s_lastFrame.mainThreadCount > 0)
+    {
+        report(std::cerr);
+        throw std::logic_error("Steady-state frame " + std::to_string(s_frames) + " made "
+            + std::to_string(s_lastFrame.mainThreadCount) + " allocation(s) on the main thread");
+    }
+}
+
+void AllocationTracker::report(std::ostream& stream)
+{
+    if (!ENABLED)
+    {
+        stream << "Allocation tracking disabled; build with TILEPUZZLE_TRACK_ALLOCATIONS\n";
+        return;
+    }
+
+    stream << "Allocations over " << s_frames << " frames: " << s_total.count << " (" << s_total.bytes / 1024 << " KiB)";
+    if (s_frames > 0)
+        stream << ", " << s_total.count / s_frames << " per frame";
+    stream << "\n";
+
+    stream << "  last frame / peak frame by scope:\n";
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i)
+    {
+        stream << "    " << CATEGORY_NAMES[i] << ": "
+            << s_lastFrame.categories[i].count << " (" << s_lastFrame.categories[i].bytes << " B) / "
+            << s_peakFrame.categories[i].count << " (" << s_peakFrame.categories[i].bytes << " B)\n";
+    }
+}
+
+#ifdef TILEPUZZLE_TRACK_ALLOCATIONS
+
+void* operator new(const size_t size) { return allocate(size); }
+void* operator new[](const size_t size) { return allocate(size); }
+void* operator new(const size_t size, const std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](const size_t size, const std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+void operator delete(void* memory) noexcept { deallocate(memory); }
+void operator delete[](void* memory) noexcept { deallocate(memory); }
+void operator delete(void* memory, size_t) noexcept { deallocate(memory); }
+void operator delete[](void* memory, size_t) noexcept { deallocate(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { deallocateAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { deallocateAligned(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { deallocateAligned(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { deallocateAligned(memory); }
+
+#endif
@@ -0,0 +1,123 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+enum class AllocationCategory : uint8_t
+{
+    Other = 0,
+    Input,
+    BoardUpdate,
+    Modifiers,
+    Render,
+    Pathfinding,
+    Count
+};
+
+/**
+ * @brief Opt-in per-frame allocation accounting.
+ * Build with TILEPUZZLE_TRACK_ALLOCATIONS defined to replace the global operator new/delete and
+ * route SDL_malloc through the tracker; otherwise nothing is hooked and scopes compile away.
+ * Allocations are attributed to the innermost Scope on the allocating thread.
+ */
+class AllocationTracker
+{
+public:
+#ifdef TILEPUZZLE_TRACK_ALLOCATIONS
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+    static constexpr size_t CATEGORY_COUNT = static_cast<size_t>(AllocationCategory::Count);
+    static constexpr uint64_t WARMUP_FRAMES = 120;              // Frames ignored by the steady-state assertion
+
+    struct Counters
+    {
+        uint64_t count{};
+        uint64_t bytes{};
+    };
+
+    struct Frame
+    {
+        std::array<Counters, CATEGORY_COUNT> categories{};
+        uint64_t frees{};
+        uint64_t mainThreadCount{};                              // Made by the thread that runs the frame loop, outside ExpectedScopes
+    };
+
+    /**
+     * @brief Marks the calling thread as the frame loop and hooks SDL's allocator.
+     * Call before SDL_Init so SDL never frees memory it got from the default allocator.
+     */
+    static void install();
+
+    /**
+     * @brief When enabled, endFrame throws if a steady frame past the warm-up allocated on the main thread
+     * outside an ExpectedScope.
+     */
+    static void setSteadyStateAssertion(bool enabled) { s_assertSteadyState = enabled; }
+
+    static void beginFrame();
+
+    /**
+     * @param steady true if nothing happened this frame that is expected to allocate, e.g. no input
+     * @throws std::logic_error in steady-state assertion mode, see setSteadyStateAssertion
+     */
+    static void endFrame(bool steady);
+
+    [[nodiscard]] static const Frame& getLastFrame() { return s_lastFrame; }
+    static void report(std::ostream& stream);
+
+    // Called from the hooks; must not allocate
+    static void recordAllocation(size_t bytes) noexcept;
+    static void recordFree() noexcept;
+
+    /**
+     * @brief Attributes allocations on this thread to category until destroyed.
+     */
+    class Scope
+    {
+    public:
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+#ifdef TILEPUZZLE_TRACK_ALLOCATIONS
+        explicit Scope(const AllocationCategory category) noexcept : m_previous(s_category) { s_category = category; }
+        ~Scope() { s_category = m_previous; }
+
+    private:
+        AllocationCategory m_previous;
+#else
+        explicit Scope(AllocationCategory) noexcept {}
+#endif
+    };
+
+    /**
+     * @brief Marks allocations on this thread as by design until destroyed, e.g. the autosave after a push.
+     * They still count towards their category but not against a steady frame.
+     */
+    class ExpectedScope
+    {
+    public:
+        ExpectedScope(const ExpectedScope&) = delete;
+        ExpectedScope& operator=(const ExpectedScope&) = delete;
+#ifdef TILEPUZZLE_TRACK_ALLOCATIONS
+        ExpectedScope() noexcept : m_previous(s_expected) { s_expected = true; }
+        ~ExpectedScope() { s_expected = m_previous; }
+
+    private:
+        bool m_previous;
+#else
+        ExpectedScope() noexcept {}
+#endif
+    };
+
+private:
+    static thread_local AllocationCategory s_category;
+    static thread_local bool s_expected;
+    static bool s_assertSteadyState;
+    static Frame s_lastFrame;
+    static Frame s_frameStart;
+    static Frame s_peakFrame;
+    static Counters s_total;
+    static uint64_t s_frames;
+};
@@ -0,0 +1,177 @@
+#include "AssetCache.h"
+#include <SDL_image.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include "SDLExceptions.h"
+
+AssetCache& AssetCache::getInstance()
+{
+    static AssetCache instance;
+    return instance;
+}
+
+void AssetCache::setPixelFormat(const uint32_t format)
+{
+    if (SDL_BYTESPERPIXEL(format) != 4)
+        throw std::invalid_argument("AssetCache stores 32-bit formats only");
+
+    if (format != m_pixelFormat)
+        m_entries.clear();
+    m_pixelFormat = format;
+}
+
+SDL_Surface* AssetCache::createSurface(const std::string& path)
+{
+    const Entry& entry = acquire(path);
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, entry.header->w, entry.header->h, 32, entry.header->format);
+    if (!surface)
+        throw SDLImageLoadException(SDL_GetError());
+
+    const auto* source = static_cast<const uint8_t*>(entry.pixels);
+    auto* destination = static_cast<uint8_t*>(surface->pixels);
+    const size_t rowBytes = static_cast<size_t>(entry.header->w) * 4;
+    for (int y = 0; y < entry.header->h; ++y)
+        std::memcpy(destination + static_cast<size_t>(y) * surface->pitch, source + static_cast<size_t>(y) * entry.header->pitch, rowBytes);
+    return surface;
+}
+
+SDL_Surface* AssetCache::createView(const std::string& path)
+{
+    const Entry& entry = acquire(path);
+
+    // SDL only reads through the view, uploading textures or converting
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<void*>(entry.pixels),
+        entry.header->w, entry.header->h, 32, entry.header->pitch, entry.header->format);
+    if (!surface)
+        throw SDLImageLoadException(SDL_GetError());
+    return surface;
+}
+
+const AssetCache::Entry& AssetCache::acquire(const std::string& path)
+{
+    if (const auto it = m_entries.find(path); it != m_entries.end())
+        return it->second;
+
+    std::ifstream source(path, std::ios::binary);
+    if (!source)
+        throw SDLImageLoadException(("Couldn't open " + path).c_str());
+    const std::string bytes{ std::istreambuf_iterator<char>(source), std::istreambuf_iterator<char>() };
+
+    const uint64_t sourceHash = hash(bytes);
+    const std::string entryPath = getEntryPath(sourceHash);
+
+    Entry entry;
+    if (map(entryPath, sourceHash, entry))
+    {
+        ++m_statistics.hits;
+    }
+    else
+    {
+        ++m_statistics.misses;
+        write(entryPath, sourceHash, bytes, path);
+        if (!map(entryPath, sourceHash, entry))
+            throw SDLImageLoadException(("Couldn't map cached " + path).c_str());
+    }
+    return m_entries.emplace(path, std::move(entry)).first->second;
+}
+
+std::string AssetCache::getEntryPath(const uint64_t sourceHash) const
+{
+    std::ostringstream name;
+    name << std::hex << std::setfill('0') << std::setw(16) << sourceHash << "-" << std::setw(8) << m_pixelFormat << ".px";
+    return (std::filesystem::path(m_directory) / name.str()).string();
+}
+
+bool AssetCache::map(const std::string& entryPath, const uint64_t sourceHash, Entry& entry) const
+{
+    std::error_code error;
+    if (!std::filesystem::exists(entryPath, error))
+        return false;
+
+    MappedFile file;
+    try
+    {
+        file = MappedFile(entryPath);
+    }
+    catch (const std::runtime_error&)
+    {
+        return false;
+    }
+
+    // Anything that doesn't match exactly is rewritten rather than trusted
+    if (file.size() < sizeof(Header))
+        return false;
+    const auto* header = reinterpret_cast<const Header*>(file.data());
+    if (std::memcmp(header->magic, "TPAC", 4) != 0 || header->version != FORMAT_VERSION ||
+        header->sourceHash != sourceHash || header->format != m_pixelFormat ||
+        header->w <= 0 || header->h <= 0 || header->pitch < header->w * 4 ||
+        file.size() < sizeof(Header) + static_cast<size_t>(header->pitch) * header->h)
+        return false;
+
+    entry.file = std::move(file);
+    entry.header = header;
+    entry.pixels = entry.file.data() + sizeof(Header);
+    return true;
+}
+
+void AssetCache::write(const std::string& entryPath, const uint64_t sourceHash, const std::string& sourceBytes, const std::string& sourceName) const
+{
+    // IMG_Load_RW picks the decoder from the bytes, so BMP and PNG take the same path
+    SDL_RWops* stream = SDL_RWFromConstMem(sourceBytes.data(), static_cast<int>(sourceBytes.size()));
+    SDL_Surface* decoded = stream ? IMG_Load_RW(stream, 1) : nullptr;
+    if (!decoded)
+        throw SDLImageLoadException((sourceName + ": " + SDL_GetError()).c_str());
+
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(decoded, m_pixelFormat, 0);
+    SDL_FreeSurface(decoded);
+    if (!converted)
+        throw SDLImageLoadException(SDL_GetError());
+
+    Header header{};
+    std::memcpy(header.magic, "TPAC", 4);
+    header.version = FORMAT_VERSION;
+    header.sourceHash = sourceHash;
+    header.format = m_pixelFormat;
+    header.w = converted->w;
+    header.h = converted->h;
+    header.pitch = converted->w * 4;
+
+    // Write under a temporary name so a crash never leaves a truncated entry behind
+    std::filesystem::create_directories(m_directory);
+    const std::string temporaryPath = entryPath + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        SDL_LockSurface(converted);
+        for (int y = 0; y < converted->h; ++y)
+            file.write(static_cast<const char*>(converted->pixels) + static_cast<size_t>(y) * converted->pitch, header.pitch);
+        SDL_UnlockSurface(converted);
+        if (!file)
+        {
+            SDL_FreeSurface(converted);
+            throw SDLImageLoadException(("Couldn't write " + temporaryPath).c_str());
+        }
+    }
+    SDL_FreeSurface(converted);
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, entryPath, error);
+    if (error)
+        throw SDLImageLoadException(("Couldn't write " + entryPath + ": " + error.message()).c_str());
+}
+
+uint64_t AssetCache::hash(const std::string& bytes)
+{
+    // 64-bit FNV-1a
+    uint64_t value = 14695981039346656037ull;
+    for (const char byte : bytes)
+    {
+        value ^= static_cast<uint8_t>(byte);
+        value *= 1099511628211ull;
+    }
+    return value;
+}
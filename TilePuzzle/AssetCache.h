@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <SDL.h>
+#include "MappedFile.h"
+
+/**
+ * @brief Persistent cache of decoded images, stored already converted to one 32-bit pixel format.
+ * Entries are keyed by a hash of the source file's bytes, so editing an asset invalidates it while
+ * renaming or copying one doesn't. Hits are memory-mapped rather than decoded; PNG and BMP
+ * sources are both decoded through SDL_image on a miss.
+ * Not thread-safe: load from one thread at a time.
+ */
+class AssetCache
+{
+public:
+    static constexpr const char* DEFAULT_DIRECTORY = "./cache/assets";
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    struct Statistics
+    {
+        uint64_t hits{};
+        uint64_t misses{};
+    };
+
+    static AssetCache& getInstance();
+
+    /**
+     * @brief Format every asset is converted to; pick one the renderer accepts without conversion.
+     * Entries written for another format are left on disk and simply not matched.
+     */
+    void setPixelFormat(uint32_t format);
+    [[nodiscard]] uint32_t getPixelFormat() const { return m_pixelFormat; }
+    void setDirectory(const std::string& directory) { m_directory = directory; }
+
+    /**
+     * @return new surface owning a copy of the decoded pixels; the caller frees it
+     * @throws SDLImageLoadException if the asset can't be read or decoded
+     */
+    SDL_Surface* createSurface(const std::string& path);
+
+    /**
+     * @return new surface that borrows the mapped pixels and must not be written to.
+     * It stays valid until release(); free it with SDL_FreeSurface as usual.
+     */
+    SDL_Surface* createView(const std::string& path);
+
+    /**
+     * @brief Unmaps every entry. Views created earlier must be freed first.
+     */
+    void release() { m_entries.clear(); }
+
+    [[nodiscard]] const Statistics& getStatistics() const { return m_statistics; }
+
+    AssetCache(const AssetCache&) = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+
+private:
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceHash;
+        uint32_t format;
+        int32_t w;
+        int32_t h;
+        int32_t pitch;
+    };
+
+    struct Entry
+    {
+        MappedFile file;
+        const Header* header{};
+        const void* pixels{};
+    };
+
+    AssetCache() = default;
+
+    const Entry& acquire(const std::string& path);
+    [[nodiscard]] std::string getEntryPath(uint64_t sourceHash) const;
+    bool map(const std::string& entryPath, uint64_t sourceHash, Entry& entry) const;
+    void write(const std::string& entryPath, uint64_t sourceHash, const std::string& sourceBytes, const std::string& sourceName) const;
+    static uint64_t hash(const std::string& bytes);
+
+    std::string m_directory = DEFAULT_DIRECTORY;
+    uint32_t m_pixelFormat = SDL_PIXELFORMAT_ARGB8888;
+    std::unordered_map<std::string, Entry> m_entries;            // By source path, for the process lifetime
+    Statistics m_statistics;
+};
@@ -0,0 +1,108 @@
+#include "AssetRegistry.h"
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    std::vector<std::string_view> split(const std::string_view text, const char separator)
+    {
+        std::vector<std::string_view> fields;
+        for (size_t start = 0;;)
+        {
+            const size_t end = text.find(separator, start);
+            fields.push_back(text.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start));
+            if (end == std::string_view::npos)
+                return fields;
+            start = end + 1;
+        }
+    }
+
+    uint8_t parseFlags(const std::string_view names, const std::initializer_list<std::pair<std::string_view, uint8_t>> known,
+        const std::string& location)
+    {
+        uint8_t flags = 0;
+        if (names.empty())
+            return flags;
+
+        for (const std::string_view name : split(names, '|'))
+        {
+            bool found = false;
+            for (const auto& [knownName, flag] : known)
+            {
+                if (name == knownName)
+                {
+                    flags |= flag;
+                    found = true;
+                }
+            }
+            if (!found)
+                throw std::runtime_error(location + "unknown flag \"" + std::string(name) + "\"");
+        }
+        return flags;
+    }
+}
+
+AssetRegistry& AssetRegistry::getInstance()
+{
+    static AssetRegistry instance(s_manifestPath);
+    return instance;
+}
+
+AssetRegistry::AssetRegistry(const std::string& manifestPath)
+{
+    std::ifstream file(manifestPath);
+    if (!file.is_open())
+        throw std::runtime_error("Could not open asset manifest: " + manifestPath);
+
+    // Built-in keys first so their ids match TEXTURE_KEYS; the manifest fills in the rest
+    for (const std::string_view key : TEXTURE_KEYS)
+    {
+        m_ids.emplace(key, static_cast<AssetId>(m_assets.size()));
+        m_assets.push_back({ .key = std::string(key) });
+    }
+
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); ++lineNumber)
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line.front() == '#')
+            continue;
+
+        const std::string location = manifestPath + ", line " + std::to_string(lineNumber) + ": ";
+        const std::vector<std::string_view> fields = split(line, ',');
+        if (fields.size() != 4 || fields[0].empty() || fields[1].empty())
+            throw std::runtime_error(location + "expected key,texture,collision,flags");
+
+        const std::string key(fields[0]);
+        if (key == TEXTURE_KEYS[EMPTY_ASSET])
+            throw std::runtime_error(location + key + " is reserved for cells without an asset");
+
+        auto [it, inserted] = m_ids.emplace(key, static_cast<AssetId>(m_assets.size()));
+        if (inserted)
+        {
+            if (m_assets.size() == INVALID_ASSET)
+                throw std::runtime_error(location + "too many assets");
+            m_assets.push_back({ .key = key });
+        }
+        else if (!m_assets[it->second].texturePath.empty())
+            throw std::runtime_error(location + key + " is defined twice");
+
+        Asset& asset = m_assets[it->second];
+        asset.texturePath = fields[1];
+        asset.collision = parseFlags(fields[2], { { "solid", SolidCollision }, { "pushable", PushableCollision } }, location);
+        asset.flags = parseFlags(fields[3], { { "goal", GoalAsset } }, location);
+    }
+
+    for (size_t id = EMPTY_ASSET + 1; id < TEXTURE_KEYS.size(); ++id)
+    {
+        if (m_assets[id].texturePath.empty())
+            throw std::runtime_error(manifestPath + " doesn't define the built-in key " + m_assets[id].key);
+    }
+}
+
+AssetId AssetRegistry::find(const std::string_view key) const
+{
+    const auto it = m_ids.find(key);
+    return it == m_ids.end() ? INVALID_ASSET : it->second;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "TextureKeys.h"
+
+/**
+ * @brief Every asset a level may use, read from a manifest and interned into dense ids at startup.
+ * Keys are only looked up while parsing levels; everything after works on ids, which index straight
+ * into the asset table. TEXTURE_KEYS take the first ids, in order, so embedded levels stay valid.
+ *
+ * Manifest lines are `key,texture,collision,flags`, where collision and flags are `|`-separated
+ * names and may be left empty. Blank lines and lines starting with '#' are skipped.
+ * Independent of SDL and read-only once loaded, so any thread may use it.
+ */
+class AssetRegistry
+{
+public:
+    static constexpr const char* DEFAULT_MANIFEST = "./sprites/manifest.txt";
+    static constexpr AssetId INVALID_ASSET = UINT16_MAX;
+
+    enum CollisionFlag : uint8_t
+    {
+        SolidCollision = 1 << 0,                                 // May be placed as an immovable object
+        PushableCollision = 1 << 1                               // May be placed as a movable object
+    };
+
+    enum AssetFlag : uint8_t
+    {
+        GoalAsset = 1 << 0                                       // As a tile, a goal to push blocks onto
+    };
+
+    struct Asset
+    {
+        std::string key{};
+        std::string texturePath{};                               // Empty only for EMPTY_ASSET
+        uint8_t collision{};                                     // CollisionFlag bits
+        uint8_t flags{};                                         // AssetFlag bits
+    };
+
+    /**
+     * @brief The registry, loaded from the manifest on first use.
+     * @throws std::runtime_error if the manifest can't be read or is malformed
+     */
+    static AssetRegistry& getInstance();
+
+    /**
+     * @brief Picks the manifest getInstance() loads; has no effect once it has been called.
+     */
+    static void setManifestPath(const std::string& path) { s_manifestPath = path; }
+
+    /**
+     * @return id of the key, or INVALID_ASSET if the manifest doesn't define it
+     */
+    [[nodiscard]] AssetId find(std::string_view key) const;
+
+    [[nodiscard]] const Asset& get(const AssetId id) const { return m_assets[id]; }
+    [[nodiscard]] const std::string& getKey(const AssetId id) const { return m_assets[id].key; }
+    [[nodiscard]] const std::string& getTexturePath(const AssetId id) const { return m_assets[id].texturePath; }
+    [[nodiscard]] bool hasCollision(const AssetId id, const CollisionFlag flag) const { return m_assets[id].collision & flag; }
+    [[nodiscard]] bool isGoal(const AssetId id) const { return m_assets[id].flags & GoalAsset; }
+    [[nodiscard]] size_t size() const { return m_assets.size(); }
+
+    AssetRegistry(const AssetRegistry&) = delete;
+    AssetRegistry& operator=(const AssetRegistry&) = delete;
+
+private:
+    // Lets find() look up string_views without building a string
+    struct KeyHash
+    {
+        using is_transparent = void;
+        size_t operator()(const std::string_view key) const { return std::hash<std::string_view>{}(key); }
+    };
+
+    explicit AssetRegistry(const std::string& manifestPath);
+
+    static inline std::string s_manifestPath = DEFAULT_MANIFEST;
+
+    std::vector<Asset> m_assets;                                 // By id
+    std::unordered_map<std::string, AssetId, KeyHash, std::equal_to<>> m_ids;
+};
@@ -0,0 +1,170 @@
+#include "AtlasPacker.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include "SDLExceptions.h"
+#include "AssetCache.h"
+
+AtlasPacker::~AtlasPacker()
+{
+    for (Item& item : m_items)
+    {
+        for (SDL_Surface* surface : item.states)
+            SDL_FreeSurface(surface);
+    }
+}
+
+void AtlasPacker::add(const std::string& path)
+{
+    SDL_Surface* source = AssetCache::getInstance().createView(path);
+
+    Item item;
+    item.name = getAtlasSpriteName(path);
+    item.w = source->w;
+    item.h = source->h;
+    for (size_t i = 0; i < SPRITE_STATE_COUNT; ++i)
+    {
+        // Same bake as StateTextures, done once here instead of at every launch
+        item.states[i] = SDL_ConvertSurfaceFormat(source, SDL_PIXELFORMAT_ARGB8888, 0);
+        if (!item.states[i])
+        {
+            SDL_FreeSurface(source);
+            for (SDL_Surface* surface : item.states)
+                SDL_FreeSurface(surface);
+            throw SDLImageLoadException(SDL_GetError());
+        }
+        getStateModifier(static_cast<SpriteState>(i)).applyTo(item.states[i]);
+    }
+    SDL_FreeSurface(source);
+
+    if (item.w * static_cast<int>(SPRITE_STATE_COUNT) + PADDING * static_cast<int>(SPRITE_STATE_COUNT + 1) > PAGE_SIZE ||
+        item.h + 2 * PADDING > PAGE_SIZE)
+    {
+        for (SDL_Surface* surface : item.states)
+            SDL_FreeSurface(surface);
+        throw std::runtime_error("Sprite too large for an atlas page: " + path);
+    }
+    m_items.push_back(std::move(item));
+}
+
+AtlasLayout AtlasPacker::save(const std::string& directory)
+{
+    // Tallest first keeps shelves tight; a sprite's states sit side by side on one shelf
+    std::vector<const Item*> order;
+    for (const Item& item : m_items)
+        order.push_back(&item);
+    std::stable_sort(order.begin(), order.end(), [](const Item* a, const Item* b) { return a->h > b->h; });
+
+    AtlasLayout layout;
+    struct Placement { const Item* item; int page; int x; int y; };
+    std::vector<Placement> placements;
+    std::vector<SDL_Point> pageExtents;                          // Used width and height of each page
+
+    int page = 0, x = PADDING, y = PADDING, shelfHeight = 0;
+    pageExtents.push_back({ 0, 0 });
+    for (const Item* item : order)
+    {
+        const int width = (item->w + PADDING) * static_cast<int>(SPRITE_STATE_COUNT);
+        if (x + width > PAGE_SIZE)
+        {
+            x = PADDING;
+            y += shelfHeight + PADDING;
+            shelfHeight = 0;
+        }
+        if (y + item->h + PADDING > PAGE_SIZE)
+        {
+            ++page;
+            pageExtents.push_back({ 0, 0 });
+            x = PADDING;
+            y = PADDING;
+            shelfHeight = 0;
+        }
+
+        placements.push_back({ item, page, x, y });
+        x += width;
+        shelfHeight = std::max(shelfHeight, item->h);
+        pageExtents[page].x = std::max(pageExtents[page].x, x);
+        pageExtents[page].y = std::max(pageExtents[page].y, y + item->h + PADDING);
+    }
+
+    std::filesystem::create_directories(directory);
+    std::vector<SDL_Surface*> pages;
+    for (size_t i = 0; i < pageExtents.size(); ++i)
+    {
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, std::max(1, pageExtents[i].x), std::max(1, pageExtents[i].y), 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!surface)
+        {
+            for (SDL_Surface* created : pages)
+                SDL_FreeSurface(created);
+            throw SDLImageLoadException(SDL_GetError());
+        }
+        SDL_FillRect(surface, nullptr, 0);
+        pages.push_back(surface);
+        layout.pages.push_back("page" + std::to_string(i) + ".bmp");
+    }
+
+    for (const auto& [item, pageIndex, left, top] : placements)
+    {
+        AtlasLayout::StateRegions& regions = layout.sprites[item->name];
+        for (size_t state = 0; state < SPRITE_STATE_COUNT; ++state)
+        {
+            SDL_Rect rect = { left + static_cast<int>(state) * (item->w + PADDING), top, item->w, item->h };
+            regions[state] = { pageIndex, rect };
+
+            // Copy alpha as is rather than blending onto the empty page
+            SDL_SetSurfaceBlendMode(item->states[state], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(item->states[state], nullptr, pages[pageIndex], &rect);
+        }
+    }
+
+    const std::filesystem::path outputDirectory(directory);
+    for (size_t i = 0; i < pages.size(); ++i)
+    {
+        const bool saved = SDL_SaveBMP(pages[i], (outputDirectory / layout.pages[i]).string().c_str()) == 0;
+        SDL_FreeSurface(pages[i]);
+        pages[i] = nullptr;
+        if (!saved)
+        {
+            for (SDL_Surface* remaining : pages)
+                SDL_FreeSurface(remaining);
+            throw SDLImageLoadException(SDL_GetError());
+        }
+    }
+
+    std::ofstream table(outputDirectory / "atlas.txt");
+    if (!table)
+        throw std::runtime_error("Failed to write " + (outputDirectory / "atlas.txt").string());
+    writeAtlasLayout(table, layout);
+    return layout;
+}
+
+int AtlasPacker::run(const std::string& sourceDirectory, const std::string& outputDirectory)
+{
+    try
+    {
+        std::vector<std::string> paths;
+        for (const auto& entry : std::filesystem::directory_iterator(sourceDirectory))
+        {
+            const std::filesystem::path extension = entry.path().extension();
+            if (entry.is_regular_file() && (extension == ".bmp" || extension == ".png"))
+                paths.push_back(entry.path().string());
+        }
+        std::sort(paths.begin(), paths.end());
+
+        AtlasPacker packer;
+        for (const std::string& path : paths)
+            packer.add(path);
+
+        const AtlasLayout layout = packer.save(outputDirectory);
+        std::cout << "Packed " << layout.sprites.size() << " sprites into " << layout.pages.size()
+            << " page(s) in " << outputDirectory << "\n";
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Atlas packing failed: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <SDL.h>
+#include "SpriteAtlas.h"
+
+/**
+ * @brief Offline tool: bakes every state of every BMP or PNG sprite and shelf-packs them into atlas pages.
+ * Run with `TilePuzzle --pack-atlas [sprite directory] [output directory]`.
+ */
+class AtlasPacker
+{
+public:
+    static constexpr int PAGE_SIZE = 2048;
+    static constexpr int PADDING = 1;                            // Transparent gap so filtering never samples a neighbour
+    static constexpr const char* DEFAULT_SOURCE = "./sprites";
+    static constexpr const char* DEFAULT_OUTPUT = "./sprites/atlas";
+
+    AtlasPacker() = default;
+    ~AtlasPacker();
+    AtlasPacker(const AtlasPacker&) = delete;
+    AtlasPacker& operator=(const AtlasPacker&) = delete;
+
+    /**
+     * @brief Adds every state of the image at path, named after its file.
+     */
+    void add(const std::string& path);
+
+    /**
+     * @brief Packs everything added so far and writes the pages and atlas.txt to directory.
+     */
+    AtlasLayout save(const std::string& directory);
+
+    /**
+     * @return process exit code
+     */
+    static int run(const std::string& sourceDirectory, const std::string& outputDirectory);
+
+private:
+    struct Item
+    {
+        std::string name;
+        SDL_Surface* states[SPRITE_STATE_COUNT]{};
+        int w{};
+        int h{};
+    };
+
+    std::vector<Item> m_items;
+};
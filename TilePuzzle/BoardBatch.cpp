@@ -0,0 +1,277 @@
+#include "BoardBatch.h"
+#include <algorithm>
+#include <stdexcept>
+#include "AssetRegistry.h"
+
+BoardBatch::BoardBatch(const size_t boardCount, const int columns, const int rows, const uint32_t maxSteps, const unsigned threadCount)
+    : m_boardCount(boardCount),
+      m_columns(columns),
+      m_rows(rows),
+      m_cellCount(static_cast<size_t>(columns) * rows),
+      m_maxSteps(maxSteps),
+      m_cells(boardCount * m_cellCount),
+      m_initialCells(boardCount * m_cellCount),
+      m_observations(boardCount * m_cellCount),
+      m_players(boardCount),
+      m_initialPlayers(boardCount),
+      m_goalCounts(boardCount),
+      m_filledGoals(boardCount),
+      m_steps(boardCount),
+      m_rewards(boardCount),
+      m_dones(boardCount),
+      m_pool(threadCount)
+{
+    if (columns <= 0 || rows <= 0)
+        throw std::invalid_argument("Board dimensions must be positive");
+
+    m_scratch.resize(m_pool.size());
+    for (auto& scratch : m_scratch)
+    {
+        scratch.distances.resize(m_cellCount);
+        scratch.queue.resize(m_cellCount);
+    }
+}
+
+void BoardBatch::loadLevel(const size_t board, const LevelLayers& level, const Vector2<int> playerStart)
+{
+    if (level.rows != m_columns || level.columns != m_rows)
+        throw std::invalid_argument("Level dimensions do not match the batch");
+    if (playerStart.x < 0 || playerStart.x >= m_columns || playerStart.y < 0 || playerStart.y >= m_rows)
+        throw std::invalid_argument("Player start is outside the board");
+
+    const AssetRegistry& registry = AssetRegistry::getInstance();
+    uint8_t* cells = &m_initialCells[board * m_cellCount];
+    for (int x = 0; x < m_columns; ++x)
+    {
+        for (int y = 0; y < m_rows; ++y)
+        {
+            const size_t cell = level.index(x, y);
+            uint8_t flags = 0;
+            if (registry.isGoal(level.tiles[cell]))
+                flags |= GoalFlag;
+            if (level.immovables[cell] != EMPTY_ASSET)
+                flags |= WallFlag;
+            if (level.movables[cell] != EMPTY_ASSET)
+                flags |= BlockFlag;
+            cells[y * m_columns + x] = flags;
+        }
+    }
+
+    const int32_t playerCell = playerStart.y * m_columns + playerStart.x;
+    if (cells[playerCell] & (WallFlag | BlockFlag))
+        throw std::invalid_argument("Player start is occupied");
+
+    m_initialPlayers[board] = playerCell;
+    resetBoard(board);
+}
+
+void BoardBatch::loadLevel(const LevelLayers& level, const Vector2<int> playerStart)
+{
+    for (size_t board = 0; board < m_boardCount; ++board)
+        loadLevel(board, level, playerStart);
+}
+
+void BoardBatch::reset()
+{
+    m_pool.parallelFor(m_boardCount, [this](const size_t begin, const size_t end, unsigned)
+    {
+        for (size_t board = begin; board < end; ++board)
+            resetBoard(board);
+    });
+}
+
+void BoardBatch::step(const BoardAction* actions)
+{
+    m_pool.parallelFor(m_boardCount, [this, actions](const size_t begin, const size_t end, const unsigned worker)
+    {
+        Scratch& scratch = m_scratch[worker];
+        for (size_t board = begin; board < end; ++board)
+        {
+            if (m_dones[board])
+                resetBoard(board);
+
+            const int32_t filledBefore = m_filledGoals[board];
+            applyAction(board, actions[board], scratch);
+            ++m_steps[board];
+
+            const bool solved = isSolved(board);
+            m_rewards[board] = static_cast<float>(m_filledGoals[board] - filledBefore) + (solved ? SOLVED_REWARD : 0.0f);
+            m_dones[board] = solved || m_steps[board] >= m_maxSteps;
+            writeObservation(board);
+        }
+    });
+}
+
+void BoardBatch::resetBoard(const size_t board)
+{
+    const size_t offset = board * m_cellCount;
+    std::copy_n(&m_initialCells[offset], m_cellCount, &m_cells[offset]);
+    m_players[board] = m_initialPlayers[board];
+    m_steps[board] = 0;
+    m_rewards[board] = 0.0f;
+    m_dones[board] = 0;
+
+    int32_t goals = 0;
+    int32_t filled = 0;
+    for (size_t i = offset; i < offset + m_cellCount; ++i)
+    {
+        if (m_cells[i] & GoalFlag)
+        {
+            ++goals;
+            if (m_cells[i] & (BlockFlag | WallFlag))
+                ++filled;
+        }
+    }
+    m_goalCounts[board] = goals;
+    m_filledGoals[board] = filled;
+    writeObservation(board);
+}
+
+void BoardBatch::applyAction(const size_t board, const BoardAction& action, Scratch& scratch)
+{
+    const uint8_t* cells = &m_cells[board * m_cellCount];
+    int32_t& player = m_players[board];
+
+    switch (action.type)
+    {
+    case BoardAction::Type::Push:
+    {
+        const int direction = static_cast<int>(action.direction);
+        const int32_t next = neighbor(player, direction);
+        if (next < 0 || (cells[next] & WallFlag))
+            return;
+
+        if (cells[next] & BlockFlag)
+            pushBlock(board, next, direction);
+        else
+            player = next;
+        return;
+    }
+
+    case BoardAction::Type::Click:
+    {
+        const int32_t target = action.cell;
+        if (target < 0 || target >= static_cast<int32_t>(m_cellCount) || (cells[target] & WallFlag))
+            return;
+
+        findDistances(board, scratch);
+
+        if (!(cells[target] & BlockFlag))
+        {
+            if (scratch.distances[target] >= 0)
+                player = target;
+            return;
+        }
+
+        // Walk to the closest reachable side of the block and push it away from the player
+        int bestDirection = -1;
+        int32_t bestCell = -1;
+        for (int direction = 0; direction < 4; ++direction)
+        {
+            const int32_t side = neighbor(target, direction);
+            if (side < 0 || scratch.distances[side] < 0)
+                continue;
+            if (bestCell < 0 || scratch.distances[side] < scratch.distances[bestCell])
+            {
+                bestCell = side;
+                bestDirection = direction;
+            }
+        }
+
+        if (bestCell < 0)
+            return;
+
+        player = bestCell;
+        pushBlock(board, target, 3 - bestDirection); // Opposite direction
+        return;
+    }
+
+    default:
+        break;
+    }
+}
+
+bool BoardBatch::pushBlock(const size_t board, const int32_t blockCell, const int direction)
+{
+    const uint8_t* cells = &m_cells[board * m_cellCount];
+    int32_t current = blockCell;
+    while (true)
+    {
+        const int32_t next = neighbor(current, direction);
+        if (next < 0 || (cells[next] & (WallFlag | BlockFlag)) || next == m_players[board])
+            break;
+        current = next;
+    }
+
+    if (current == blockCell)
+        return false;
+
+    moveBlock(board, blockCell, current);
+    return true;
+}
+
+void BoardBatch::moveBlock(const size_t board, const int32_t from, const int32_t to)
+{
+    uint8_t* cells = &m_cells[board * m_cellCount];
+    cells[from] &= ~BlockFlag;
+    cells[to] |= BlockFlag;
+
+    if (cells[from] & GoalFlag)
+        --m_filledGoals[board];
+    if (cells[to] & GoalFlag)
+        ++m_filledGoals[board];
+}
+
+void BoardBatch::findDistances(const size_t board, Scratch& scratch) const
+{
+    const uint8_t* cells = &m_cells[board * m_cellCount];
+    std::fill(scratch.distances.begin(), scratch.distances.end(), -1);
+
+    size_t head = 0;
+    size_t tail = 0;
+    scratch.queue[tail++] = m_players[board];
+    scratch.distances[m_players[board]] = 0;
+
+    while (head < tail)
+    {
+        const int32_t cell = scratch.queue[head++];
+        for (int direction = 0; direction < 4; ++direction)
+        {
+            const int32_t next = neighbor(cell, direction);
+            if (next < 0 || scratch.distances[next] >= 0 || (cells[next] & (WallFlag | BlockFlag)))
+                continue;
+            scratch.distances[next] = scratch.distances[cell] + 1;
+            scratch.queue[tail++] = next;
+        }
+    }
+}
+
+void BoardBatch::writeObservation(const size_t board)
+{
+    const size_t offset = board * m_cellCount;
+    const uint8_t* cells = &m_cells[offset];
+    uint8_t* observation = &m_observations[offset];
+
+    for (size_t i = 0; i < m_cellCount; ++i)
+    {
+        const uint8_t flags = cells[i];
+        const bool goal = flags & GoalFlag;
+        if (flags & WallFlag)
+            observation[i] = Wall;
+        else if (flags & BlockFlag)
+            observation[i] = goal ? BlockOnGoal : Block;
+        else
+            observation[i] = goal ? Goal : Floor;
+    }
+
+    observation[m_players[board]] = (cells[m_players[board]] & GoalFlag) ? PlayerOnGoal : Player;
+}
+
+int32_t BoardBatch::neighbor(const int32_t cell, const int direction) const
+{
+    const int x = cell % m_columns + DIRECTIONS[direction].x;
+    const int y = cell / m_columns + DIRECTIONS[direction].y;
+    if (x < 0 || x >= m_columns || y < 0 || y >= m_rows)
+        return -1;
+    return y * m_columns + x;
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "LevelData.h"
+#include "Vector2.h"
+#include "WorkerPool.h"
+
+/**
+ * @brief One action per board and step.
+ * Click mirrors GameBoard::onClick: walk to a free cell, or walk next to a block and push it away.
+ * Push pushes the block next to the player in a direction, or steps that way if the cell is free.
+ */
+struct BoardAction
+{
+    enum class Type : uint8_t
+    {
+        None = 0,
+        Click,
+        Push
+    };
+
+    // Same order as GameBoard's neighbour directions
+    enum class Direction : uint8_t
+    {
+        Up = 0,
+        Left,
+        Right,
+        Down
+    };
+
+    Type type = Type::None;
+    Direction direction = Direction::Up;
+    int32_t cell{};                      // Click target, y * columns + x
+};
+
+/**
+ * @brief Steps many independent boards of the same size without SDL.
+ * State is kept as structure-of-arrays; observations, rewards and done flags are each one contiguous array
+ * indexed by board. Blocks slide until they hit a wall, another block or the board edge, as in GameBoard::pushTile.
+ * A board that finished on one step is reset to its level at the start of the next.
+ */
+class BoardBatch
+{
+public:
+    enum TileCode : uint8_t
+    {
+        Floor = 0,
+        Goal,
+        Wall,
+        Block,
+        BlockOnGoal,
+        Player,
+        PlayerOnGoal
+    };
+
+    static constexpr float SOLVED_REWARD = 10.0f;
+
+    BoardBatch(size_t boardCount, int columns, int rows, uint32_t maxSteps = 200,
+        unsigned threadCount = std::thread::hardware_concurrency());
+
+    /**
+     * @brief Loads a level into one board; x indexes the level's file rows, as in GameBoard.
+     * Immovable objects become walls, movable objects blocks and goal tiles (flagged in the manifest) goals.
+     */
+    void loadLevel(size_t board, const LevelLayers& level, Vector2<int> playerStart);
+    void loadLevel(const LevelLayers& level, Vector2<int> playerStart);
+
+    void reset();
+
+    /**
+     * @param actions one action per board
+     */
+    void step(const BoardAction* actions);
+
+    [[nodiscard]] size_t getBoardCount() const { return m_boardCount; }
+    [[nodiscard]] int getColumns() const { return m_columns; }
+    [[nodiscard]] int getRows() const { return m_rows; }
+    [[nodiscard]] size_t getCellCount() const { return m_cellCount; }
+
+    // Board b's observation starts at getObservations() + b * getCellCount()
+    [[nodiscard]] const uint8_t* getObservations() const { return m_observations.data(); }
+    [[nodiscard]] const float* getRewards() const { return m_rewards.data(); }
+    [[nodiscard]] const uint8_t* getDones() const { return m_dones.data(); }
+
+private:
+    enum CellFlag : uint8_t
+    {
+        WallFlag = 1 << 0,
+        GoalFlag = 1 << 1,
+        BlockFlag = 1 << 2
+    };
+
+    struct Scratch
+    {
+        std::vector<int32_t> distances;
+        std::vector<int32_t> queue;
+    };
+
+    void resetBoard(size_t board);
+    void applyAction(size_t board, const BoardAction& action, Scratch& scratch);
+    bool pushBlock(size_t board, int32_t blockCell, int direction);
+    void moveBlock(size_t board, int32_t from, int32_t to);
+    void findDistances(size_t board, Scratch& scratch) const;
+    void writeObservation(size_t board);
+    [[nodiscard]] int32_t neighbor(int32_t cell, int direction) const;
+    [[nodiscard]] bool isSolved(size_t board) const { return m_goalCounts[board] > 0 && m_filledGoals[board] == m_goalCounts[board]; }
+
+    static constexpr std::array<Vector2<int>, 4> DIRECTIONS = { Vector2{ 0, -1 }, Vector2{ -1, 0 }, Vector2{ 1, 0 }, Vector2{ 0, 1 } };
+
+    size_t m_boardCount;
+    int m_columns;
+    int m_rows;
+    size_t m_cellCount;
+    uint32_t m_maxSteps;
+
+    // Per cell, board-major
+    std::vector<uint8_t> m_cells;
+    std::vector<uint8_t> m_initialCells;
+    std::vector<uint8_t> m_observations;
+
+    // Per board
+    std::vector<int32_t> m_players;
+    std::vector<int32_t> m_initialPlayers;
+    std::vector<int32_t> m_goalCounts;
+    std::vector<int32_t> m_filledGoals;
+    std::vector<uint32_t> m_steps;
+    std::vector<float> m_rewards;
+    std::vector<uint8_t> m_dones;
+
+    WorkerPool m_pool;
+    std::vector<Scratch> m_scratch;                  // One per worker
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <SDL.h>
+#include "Vector2.h"
+
+/**
+ * @brief Screen <-> board coordinate conversions for a tile size known at compile time.
+ * Power-of-two tile sizes reduce to shifts and masks, everything else to constant division.
+ * Both round toward negative infinity, so coordinates left of or above the board map to negative cells on either axis.
+ */
+template <int TileWidth, int TileHeight>
+struct BoardGeometry
+{
+    static_assert(TileWidth > 0 && TileHeight > 0, "Tile dimensions must be positive");
+
+    static constexpr Vector2<int> TILE_DIMENSIONS = { TileWidth, TileHeight };
+
+    /**
+     * @return top-left corner of the tile enclosing the screen coordinates
+     */
+    [[nodiscard]] static constexpr Vector2<int> snapScreenCoordinates(const Vector2<int> coordinates)
+    {
+        return
+        {
+            coordinates.x - modulo<TileWidth>(coordinates.x),
+            coordinates.y - modulo<TileHeight>(coordinates.y)
+        };
+    }
+
+    /**
+     * @return position that centers a sprite of the given size on the enclosing tile
+     */
+    [[nodiscard]] static constexpr Vector2<int> centerScreenCoordinates(const Vector2<int> coordinates, const SDL_Rect& spriteDimensions)
+    {
+        const Vector2<int> snapped = snapScreenCoordinates(coordinates);
+        return
+        {
+            snapped.x + (TileWidth / 2) - (spriteDimensions.w / 2),
+            snapped.y + (TileHeight / 2) - (spriteDimensions.h / 2)
+        };
+    }
+
+    [[nodiscard]] static constexpr Vector2<int> toBoardCoordinates(const Vector2<int> coordinates)
+    {
+        return { divide<TileWidth>(coordinates.x), divide<TileHeight>(coordinates.y) };
+    }
+
+    [[nodiscard]] static constexpr Vector2<int> toScreenCoordinates(const Vector2<int> boardCoordinates)
+    {
+        return { multiply<TileWidth>(boardCoordinates.x), multiply<TileHeight>(boardCoordinates.y) };
+    }
+
+private:
+    static constexpr bool isPowerOfTwo(const int value) { return (value & (value - 1)) == 0; }
+
+    static constexpr int log2(int value)
+    {
+        int shift = 0;
+        while (value >>= 1)
+            ++shift;
+        return shift;
+    }
+
+    template <int Divisor>
+    static constexpr int divide(const int value)
+    {
+        if constexpr (isPowerOfTwo(Divisor))
+            return value >> log2(Divisor);
+        else
+        {
+            const int quotient = value / Divisor;
+            return quotient - (value % Divisor < 0);
+        }
+    }
+
+    template <int Divisor>
+    static constexpr int modulo(const int value)
+    {
+        if constexpr (isPowerOfTwo(Divisor))
+            return value & (Divisor - 1);
+        else
+        {
+            const int remainder = value % Divisor;
+            return remainder < 0 ? remainder + Divisor : remainder;
+        }
+    }
+
+    template <int Factor>
+    static constexpr int multiply(const int value)
+    {
+        if constexpr (isPowerOfTwo(Factor))
+            return value << log2(Factor);
+        else
+            return value * Factor;
+    }
+};
+
+using TileGeometry = BoardGeometry<86, 64>;
+
+static_assert(TileGeometry::snapScreenCoordinates({ 100, 70 }) == Vector2<int>{ 86, 64 });
+static_assert(TileGeometry::toBoardCoordinates({ 171, 128 }) == Vector2<int>{ 1, 2 });
+static_assert(BoardGeometry<64, 32>::toBoardCoordinates({ 130, 70 }) == Vector2<int>{ 2, 2 });
+static_assert(BoardGeometry<64, 32>::snapScreenCoordinates({ 130, 70 }) == Vector2<int>{ 128, 64 });
+static_assert(TileGeometry::toBoardCoordinates({ -10, -5 }) == Vector2<int>{ -1, -1 });
+static_assert(TileGeometry::toBoardCoordinates({ -86, -64 }) == Vector2<int>{ -1, -1 });
+static_assert(TileGeometry::snapScreenCoordinates({ -10, -5 }) == Vector2<int>{ -86, -64 });
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Immutable copy of the board's occupancy, cheap to hand to worker threads.
+ * GameBoard shares one instance until it changes, then copies before writing.
+ */
+struct BoardSnapshot
+{
+    enum CellFlag : uint8_t
+    {
+        WallFlag = 1 << 0,
+        GoalFlag = 1 << 1,
+        BlockFlag = 1 << 2
+    };
+
+    int columns{};
+    int rows{};
+    std::vector<uint8_t> cells;   // y * columns + x
+    int32_t playerCell{};
+    uint64_t version{};
+
+    [[nodiscard]] int32_t neighbor(const int32_t cell, const int direction) const
+    {
+        // Same order as GameBoard's neighbour directions: up, left, right, down
+        static constexpr int dx[] = { 0, -1, 1, 0 };
+        static constexpr int dy[] = { -1, 0, 0, 1 };
+        const int x = cell % columns + dx[direction];
+        const int y = cell / columns + dy[direction];
+        if (x < 0 || x >= columns || y < 0 || y >= rows)
+            return -1;
+        return y * columns + x;
+    }
+};
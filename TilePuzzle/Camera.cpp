@@ -0,0 +1,55 @@
+#include "Camera.h"
+#include <algorithm>
+#include <cmath>
+
+void Camera::pan(const Vector2<double> screenDelta)
+{
+    m_position -= screenDelta * (1.0 / m_zoom);
+}
+
+void Camera::zoomAt(const Vector2<int> screenPoint, const double factor)
+{
+    const double zoom = std::clamp(m_zoom * factor, MIN_ZOOM, MAX_ZOOM);
+
+    // Keep the world point under the cursor fixed
+    const Vector2<double> anchor = screenPoint;
+    m_position += anchor * (1.0 / m_zoom) - anchor * (1.0 / zoom);
+    m_zoom = zoom;
+}
+
+void Camera::reset()
+{
+    m_position = {};
+    m_zoom = 1.0;
+}
+
+Vector2<int> Camera::screenToWorld(const Vector2<int> screenPoint) const
+{
+    return
+    {
+        static_cast<int>(std::floor(m_position.x + screenPoint.x / m_zoom)),
+        static_cast<int>(std::floor(m_position.y + screenPoint.y / m_zoom))
+    };
+}
+
+SDL_Rect Camera::worldToScreen(const SDL_Rect& worldRect) const
+{
+    const int left = static_cast<int>(std::lround((worldRect.x - m_position.x) * m_zoom));
+    const int top = static_cast<int>(std::lround((worldRect.y - m_position.y) * m_zoom));
+    const int right = static_cast<int>(std::lround((worldRect.x + worldRect.w - m_position.x) * m_zoom));
+    const int bottom = static_cast<int>(std::lround((worldRect.y + worldRect.h - m_position.y) * m_zoom));
+    return { left, top, right - left, bottom - top };
+}
+
+SDL_Rect Camera::getVisibleRect() const
+{
+    const Vector2<int> topLeft = screenToWorld({ 0, 0 });
+    const Vector2<int> bottomRight = screenToWorld(m_viewportDimensions);
+    return { topLeft.x, topLeft.y, bottomRight.x - topLeft.x + 1, bottomRight.y - topLeft.y + 1 };
+}
+
+bool Camera::isVisible(const SDL_Rect& worldRect) const
+{
+    const SDL_Rect visible = getVisibleRect();
+    return SDL_HasIntersection(&visible, &worldRect) == SDL_TRUE;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <SDL.h>
+#include "Vector2.h"
+
+/**
+ * @brief Maps world (board) pixels to window pixels with a pan offset and uniform zoom.
+ */
+class Camera
+{
+public:
+    static constexpr double MIN_ZOOM = 0.25;
+    static constexpr double MAX_ZOOM = 4.0;
+
+    explicit Camera(Vector2<int> viewportDimensions) : m_viewportDimensions(viewportDimensions) {}
+
+    /**
+     * @param screenDelta distance in window pixels; the world moves with the cursor
+     */
+    void pan(Vector2<double> screenDelta);
+
+    /**
+     * @brief Scales the zoom by factor, keeping the world point under screenPoint in place.
+     */
+    void zoomAt(Vector2<int> screenPoint, double factor);
+    void reset();
+    void setViewportDimensions(const Vector2<int> dimensions) { m_viewportDimensions = dimensions; }
+
+    [[nodiscard]] double getZoom() const { return m_zoom; }
+    [[nodiscard]] Vector2<int> screenToWorld(Vector2<int> screenPoint) const;
+
+    /**
+     * @brief Edges are rounded independently so adjacent world rects stay seamless on screen.
+     */
+    [[nodiscard]] SDL_Rect worldToScreen(const SDL_Rect& worldRect) const;
+
+    /**
+     * @return world-space rect covered by the viewport
+     */
+    [[nodiscard]] SDL_Rect getVisibleRect() const;
+    [[nodiscard]] bool isVisible(const SDL_Rect& worldRect) const;
+
+private:
+    Vector2<double> m_position{};                                // World point at the viewport's top-left corner
+    double m_zoom = 1.0;
+    Vector2<int> m_viewportDimensions;
+};
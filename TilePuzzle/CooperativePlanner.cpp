@@ -0,0 +1,402 @@
+#include "CooperativePlanner.h"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    constexpr int DX[] = { 0, -1, 1, 0 };
+    constexpr int DY[] = { -1, 0, 0, 1 };
+    constexpr int WAIT = 4;
+
+    struct OpenNode
+    {
+        int f{};
+        int g{};
+        int32_t node{};
+
+        bool operator>(const OpenNode& other) const { return f != other.f ? f > other.f : g < other.g; }
+    };
+}
+
+CooperativePlanner::CooperativePlanner(const unsigned threadCount)
+    : m_pool(std::max(threadCount, 1u))
+{}
+
+void CooperativePlanner::rebuild(const BoardSnapshot& snapshot)
+{
+    if (snapshot.columns != m_columns || snapshot.rows != m_rows)
+    {
+        // Cells no longer mean the same thing
+        m_columns = snapshot.columns;
+        m_rows = snapshot.rows;
+        m_agents.clear();
+        m_queue.clear();
+        m_reservations.assign(snapshot.cells.size(), {});
+        m_parks.assign(snapshot.cells.size(), {});
+    }
+
+    m_blocked.resize(snapshot.cells.size());
+    for (size_t i = 0; i < snapshot.cells.size(); ++i)
+        m_blocked[i] = (snapshot.cells[i] & (BoardSnapshot::WallFlag | BoardSnapshot::BlockFlag)) != 0;
+    replanAll();
+}
+
+void CooperativePlanner::setBlocked(const int32_t cell, const bool blocked)
+{
+    if ((m_blocked[cell] != 0) == blocked)
+        return;
+    m_blocked[cell] = blocked;
+    replanAll();
+}
+
+CooperativePlanner::AgentId CooperativePlanner::addAgent(const int32_t cell, const int32_t goal)
+{
+    if (cell < 0 || cell >= static_cast<int32_t>(m_blocked.size()) || !isFree(cell) ||
+        isReserved(cell, m_time, -1) || !canPark(cell, m_time, -1))
+        throw std::runtime_error("Agent cell " + std::to_string(cell) + " is not free");
+
+    const auto agent = static_cast<AgentId>(m_agents.size());
+    Agent& added = m_agents.emplace_back();
+    added.active = true;
+    added.path = { cell };
+    reserve(agent);
+    setGoal(agent, goal);
+    return agent;
+}
+
+void CooperativePlanner::removeAgent(const AgentId agent)
+{
+    release(agent);
+    m_agents[agent].active = false;
+}
+
+void CooperativePlanner::setGoal(const AgentId agent, const int32_t goal)
+{
+    Agent& target = m_agents[agent];
+    target.goal = goal;
+    target.distances = getDistances(goal);
+    target.stuck = false;
+    enqueue(agent);
+}
+
+void CooperativePlanner::plan()
+{
+    m_lastExpansions = 0;
+    const size_t batchSize = std::max<size_t>(m_budget / MAX_EXPANSIONS_PER_PLAN, 1);
+
+    std::vector<AgentId> batch;
+    while (!m_queue.empty() && batch.size() < batchSize)
+    {
+        const AgentId agent = m_queue.front();
+        m_queue.pop_front();
+        m_agents[agent].queued = false;
+        if (m_agents[agent].active)
+            batch.push_back(agent);
+    }
+    if (batch.empty())
+        return;
+
+    // Reservations are read-only until every search in the batch is done
+    std::vector<Plan> plans(batch.size());
+    m_pool.parallelFor(batch.size(), [&](const size_t begin, const size_t end, unsigned)
+    {
+        for (size_t i = begin; i < end; ++i)
+            plans[i] = search(batch[i]);
+    });
+
+    std::vector<AgentId> clashed;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        const AgentId agent = batch[i];
+        Plan& result = plans[i];
+        m_lastExpansions += result.expansions;
+
+        if (result.unreachable)
+        {
+            m_agents[agent].stuck = true;
+            continue;
+        }
+        if (!result.found)
+        {
+            // Keeps walking its current plan meanwhile
+            enqueue(agent);
+            continue;
+        }
+        if (!isValid(result.path, agent))
+        {
+            clashed.push_back(agent);
+            continue;
+        }
+
+        release(agent);
+        m_agents[agent].path = std::move(result.path);
+        reserve(agent);
+    }
+
+    for (auto agent = clashed.rbegin(); agent != clashed.rend(); ++agent)
+        enqueue(*agent, true);
+}
+
+const std::vector<CooperativePlanner::AgentId>& CooperativePlanner::advance()
+{
+    m_moved.clear();
+    ++m_time;
+
+    for (AgentId agent = 0; agent < static_cast<AgentId>(m_agents.size()); ++agent)
+    {
+        Agent& current = m_agents[agent];
+        if (!current.active)
+            continue;
+
+        if (current.path.size() > 1)
+        {
+            // Drop the reservation that just went by
+            std::vector<Reservation>& reservations = m_reservations[current.path.front()];
+            const auto passed = std::find_if(reservations.begin(), reservations.end(),
+                [&](const Reservation& r) { return r.agent == agent && r.time == m_time - 1; });
+            if (passed != reservations.end())
+            {
+                *passed = reservations.back();
+                reservations.pop_back();
+            }
+
+            const int32_t previous = current.path.front();
+            current.path.erase(current.path.begin());
+            if (current.path.front() != previous)
+                m_moved.push_back(agent);
+        }
+
+        const bool reachesGoal = current.path.back() == current.goal;
+        if (!current.queued && !current.stuck && !reachesGoal &&
+            current.path.size() - 1 <= static_cast<size_t>(WINDOW - REPLAN_INTERVAL))
+            enqueue(agent);
+    }
+    return m_moved;
+}
+
+CooperativePlanner::Plan CooperativePlanner::search(const AgentId agent) const
+{
+    const Agent& current = m_agents[agent];
+    const DistanceMap& distances = *current.distances;
+    const int32_t start = current.path.front();
+
+    Plan plan;
+    if (distances[start] == UNREACHABLE)
+    {
+        plan.unreachable = true;
+        return plan;
+    }
+
+    struct Node
+    {
+        int32_t cell{};
+        int32_t parent{};
+        int g{};
+        int depth{};
+        bool closed{};
+    };
+    std::vector<Node> nodes;
+    std::unordered_map<uint64_t, int32_t> nodeIndices;   // By depth and cell
+    std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<>> openList;
+    const auto cellCount = static_cast<uint64_t>(m_blocked.size());
+
+    nodes.push_back({ start, -1, 0, 0, false });
+    nodeIndices.emplace(start, 0);
+    openList.push({ distances[start], 0, 0 });
+
+    while (!openList.empty())
+    {
+        const OpenNode top = openList.top();
+        openList.pop();
+        if (nodes[top.node].closed || top.g > nodes[top.node].g)
+            continue;
+        nodes[top.node].closed = true;
+        const Node node = nodes[top.node];
+
+        // Done once the agent can stay where it is: at the goal, or at the edge of the window
+        if ((node.cell == current.goal || node.depth == WINDOW) && canPark(node.cell, m_time + node.depth, agent))
+        {
+            for (int32_t index = top.node; index >= 0; index = nodes[index].parent)
+                plan.path.push_back(nodes[index].cell);
+            std::reverse(plan.path.begin(), plan.path.end());
+            plan.found = true;
+            return plan;
+        }
+        if (node.depth == WINDOW)
+            continue;
+        if (++plan.expansions > MAX_EXPANSIONS_PER_PLAN)
+            break;
+
+        const uint32_t arrival = m_time + node.depth + 1;
+        for (int action = 0; action <= WAIT; ++action)
+        {
+            const int32_t next = action == WAIT ? node.cell : getNeighbor(node.cell, action);
+            if (!isFree(next) || distances[next] == UNREACHABLE)
+                continue;
+            if (isReserved(next, arrival, agent) || (next != node.cell && isSwap(node.cell, next, arrival - 1, agent)))
+                continue;
+
+            const int g = node.g + 1;
+            const auto [entry, inserted] = nodeIndices.try_emplace((node.depth + 1) * cellCount + next, static_cast<int32_t>(nodes.size()));
+            if (inserted)
+                nodes.push_back({ next, top.node, g, node.depth + 1, false });
+            else
+            {
+                Node& existing = nodes[entry->second];
+                if (existing.closed || g >= existing.g)
+                    continue;
+                existing.g = g;
+                existing.parent = top.node;
+            }
+            openList.push({ g + distances[next], g, entry->second });
+        }
+    }
+    return plan;
+}
+
+int32_t CooperativePlanner::getNeighbor(const int32_t cell, const int direction) const
+{
+    const int x = cell % m_columns + DX[direction];
+    const int y = cell / m_columns + DY[direction];
+    if (x < 0 || x >= m_columns || y < 0 || y >= m_rows)
+        return -1;
+    return y * m_columns + x;
+}
+
+bool CooperativePlanner::isReserved(const int32_t cell, const uint32_t time, const AgentId self) const
+{
+    const Park& park = m_parks[cell];
+    if (park.agent >= 0 && park.agent != self && time >= park.from)
+        return true;
+    for (const Reservation& reservation : m_reservations[cell])
+    {
+        if (reservation.time == time && reservation.agent != self)
+            return true;
+    }
+    return false;
+}
+
+bool CooperativePlanner::isSwap(const int32_t from, const int32_t to, const uint32_t time, const AgentId self) const
+{
+    // Someone on the destination now who moves onto our cell as we leave it
+    for (const Reservation& reservation : m_reservations[to])
+    {
+        if (reservation.time != time || reservation.agent == self)
+            continue;
+
+        const Park& park = m_parks[from];
+        if (park.agent == reservation.agent && park.from <= time + 1)
+            return true;
+        for (const Reservation& other : m_reservations[from])
+        {
+            if (other.agent == reservation.agent && other.time == time + 1)
+                return true;
+        }
+    }
+    return false;
+}
+
+bool CooperativePlanner::canPark(const int32_t cell, const uint32_t time, const AgentId self) const
+{
+    const Park& park = m_parks[cell];
+    if (park.agent >= 0 && park.agent != self)
+        return false;
+    for (const Reservation& reservation : m_reservations[cell])
+    {
+        if (reservation.time >= time && reservation.agent != self)
+            return false;
+    }
+    return true;
+}
+
+bool CooperativePlanner::isValid(const std::vector<int32_t>& path, const AgentId self) const
+{
+    for (size_t i = 1; i < path.size(); ++i)
+    {
+        const auto time = static_cast<uint32_t>(m_time + i);
+        if (isReserved(path[i], time, self) || (path[i] != path[i - 1] && isSwap(path[i - 1], path[i], time - 1, self)))
+            return false;
+    }
+    return canPark(path.back(), static_cast<uint32_t>(m_time + path.size() - 1), self);
+}
+
+void CooperativePlanner::reserve(const AgentId agent)
+{
+    const std::vector<int32_t>& path = m_agents[agent].path;
+    for (size_t i = 0; i + 1 < path.size(); ++i)
+        m_reservations[path[i]].push_back({ static_cast<uint32_t>(m_time + i), agent });
+    m_parks[path.back()] = { agent, static_cast<uint32_t>(m_time + path.size() - 1) };
+}
+
+void CooperativePlanner::release(const AgentId agent)
+{
+    const std::vector<int32_t>& path = m_agents[agent].path;
+    for (size_t i = 0; i + 1 < path.size(); ++i)
+    {
+        std::vector<Reservation>& reservations = m_reservations[path[i]];
+        const auto time = static_cast<uint32_t>(m_time + i);
+        const auto found = std::find_if(reservations.begin(), reservations.end(),
+            [&](const Reservation& r) { return r.agent == agent && r.time == time; });
+        if (found != reservations.end())
+        {
+            *found = reservations.back();
+            reservations.pop_back();
+        }
+    }
+    if (m_parks[path.back()].agent == agent)
+        m_parks[path.back()] = {};
+}
+
+void CooperativePlanner::enqueue(const AgentId agent, const bool first)
+{
+    Agent& target = m_agents[agent];
+    if (target.queued)
+        return;
+    target.queued = true;
+    if (first)
+        m_queue.push_front(agent);
+    else
+        m_queue.push_back(agent);
+}
+
+void CooperativePlanner::replanAll()
+{
+    m_distanceMaps.clear();
+    for (AgentId agent = 0; agent < static_cast<AgentId>(m_agents.size()); ++agent)
+    {
+        if (m_agents[agent].active)
+            setGoal(agent, m_agents[agent].goal);
+    }
+}
+
+std::shared_ptr<const CooperativePlanner::DistanceMap> CooperativePlanner::getDistances(const int32_t goal)
+{
+    if (const auto found = m_distanceMaps.find(goal); found != m_distanceMaps.end())
+        return found->second;
+
+    // Walking distance to the goal with every agent ignored, by breadth-first search from it
+    auto distances = std::make_shared<DistanceMap>(m_blocked.size(), UNREACHABLE);
+    if (goal >= 0 && goal < static_cast<int32_t>(m_blocked.size()) && isFree(goal))
+    {
+        std::vector<int32_t> queue{ goal };
+        (*distances)[goal] = 0;
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            const int32_t cell = queue[head];
+            for (int direction = 0; direction < 4; ++direction)
+            {
+                const int32_t next = getNeighbor(cell, direction);
+                if (!isFree(next) || (*distances)[next] != UNREACHABLE)
+                    continue;
+                (*distances)[next] = static_cast<uint16_t>((*distances)[cell] + 1);
+                queue.push_back(next);
+            }
+        }
+    }
+
+    m_distanceMaps.emplace(goal, distances);
+    return distances;
+}
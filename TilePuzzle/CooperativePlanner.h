@@ -0,0 +1,134 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "BoardSnapshot.h"
+#include "WorkerPool.h"
+
+/**
+ * @brief Conflict-free movement for many autonomous movers (windowed hierarchical cooperative A*).
+ * Time advances in discrete steps of one tile. Every agent owns a space-time reservation for each
+ * cell of its plan, WINDOW steps ahead, and keeps the last one for good once the plan runs out.
+ * Agents plan again after walking REPLAN_INTERVAL steps, searching (cell, time) with the walking
+ * distance to their goal, ignoring other agents, as the heuristic. Queued agents are planned in
+ * parallel against the reservations committed so far, then committed in queue order; a plan that
+ * clashes with one committed before it in the same batch is retried first next time.
+ */
+class CooperativePlanner
+{
+public:
+    using AgentId = int32_t;
+
+    static constexpr int WINDOW = 16;
+    static constexpr int REPLAN_INTERVAL = WINDOW / 2;
+    static constexpr size_t MAX_EXPANSIONS_PER_PLAN = 4096;       // A search that needs more waits for the next batch
+    static constexpr size_t DEFAULT_BUDGET = 16 * MAX_EXPANSIONS_PER_PLAN;
+
+    explicit CooperativePlanner(unsigned threadCount = std::thread::hardware_concurrency());
+
+    /**
+     * @brief Takes walls and blocks from the snapshot. Agents are kept unless the board was resized.
+     */
+    void rebuild(const BoardSnapshot& snapshot);
+
+    /**
+     * @brief Marks a cell as free or obstructed; every agent plans again.
+     */
+    void setBlocked(int32_t cell, bool blocked);
+
+    /**
+     * @throw std::runtime_error if the cell is obstructed or held by another agent
+     */
+    AgentId addAgent(int32_t cell, int32_t goal);
+    void removeAgent(AgentId agent);
+    void setGoal(AgentId agent, int32_t goal);
+
+    /**
+     * @brief Search expansions plan() may spend per call, split into batches of whole plans.
+     */
+    void setBudget(const size_t expansions) { m_budget = expansions; }
+    [[nodiscard]] size_t getBudget() const { return m_budget; }
+
+    /**
+     * @brief Plans queued agents on the worker threads, within the budget.
+     */
+    void plan();
+
+    /**
+     * @brief Moves every agent to its next planned cell.
+     * @return agents that changed cell
+     */
+    const std::vector<AgentId>& advance();
+
+    [[nodiscard]] int32_t getCell(AgentId agent) const { return m_agents[agent].path.front(); }
+    [[nodiscard]] int32_t getGoal(AgentId agent) const { return m_agents[agent].goal; }
+    [[nodiscard]] size_t getAgentCount() const { return m_agents.size(); }
+    [[nodiscard]] size_t getQueuedCount() const { return m_queue.size(); }
+    [[nodiscard]] size_t getLastExpansions() const { return m_lastExpansions; }
+    [[nodiscard]] uint32_t getTime() const { return m_time; }
+
+private:
+    static constexpr uint16_t UNREACHABLE = UINT16_MAX;
+    using DistanceMap = std::vector<uint16_t>;
+
+    struct Agent
+    {
+        int32_t goal{};
+        std::vector<int32_t> path;   // Cell at m_time + i; the agent stays on the last one afterwards
+        std::shared_ptr<const DistanceMap> distances;
+        bool active{};
+        bool queued{};
+        bool stuck{};                // Goal unreachable on the current board
+    };
+
+    struct Reservation
+    {
+        uint32_t time{};
+        AgentId agent{};
+    };
+
+    struct Park
+    {
+        AgentId agent = -1;
+        uint32_t from{};
+    };
+
+    struct Plan
+    {
+        std::vector<int32_t> path;
+        size_t expansions{};
+        bool found{};
+        bool unreachable{};
+    };
+
+    [[nodiscard]] Plan search(AgentId agent) const;
+    [[nodiscard]] bool isFree(int32_t cell) const { return cell >= 0 && !m_blocked[cell]; }
+    [[nodiscard]] int32_t getNeighbor(int32_t cell, int direction) const;
+    [[nodiscard]] bool isReserved(int32_t cell, uint32_t time, AgentId self) const;
+    [[nodiscard]] bool isSwap(int32_t from, int32_t to, uint32_t time, AgentId self) const;
+    [[nodiscard]] bool canPark(int32_t cell, uint32_t time, AgentId self) const;
+    [[nodiscard]] bool isValid(const std::vector<int32_t>& path, AgentId self) const;
+    void reserve(AgentId agent);
+    void release(AgentId agent);
+    void enqueue(AgentId agent, bool first = false);
+    void replanAll();
+    std::shared_ptr<const DistanceMap> getDistances(int32_t goal);
+
+    int m_columns{};
+    int m_rows{};
+    std::vector<uint8_t> m_blocked;
+    std::vector<std::vector<Reservation>> m_reservations;  // By cell
+    std::vector<Park> m_parks;                             // By cell
+    std::vector<Agent> m_agents;
+    std::deque<AgentId> m_queue;
+    std::unordered_map<int32_t, std::shared_ptr<const DistanceMap>> m_distanceMaps;  // By goal, shared between agents
+    std::vector<AgentId> m_moved;
+    uint32_t m_time{};
+    size_t m_budget = DEFAULT_BUDGET;
+    size_t m_lastExpansions{};
+    WorkerPool m_pool;
+};
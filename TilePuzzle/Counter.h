@@ -1,16 +1,16 @@
 #pragma once
 
 #include <chrono>
-#include <algorithm>
+#include <cstdint>
 
 class Counter
 {
 public:
     using clock = std::chrono::steady_clock;
 
-    Counter(const unsigned int targetFps) : 
-        m_targetDeltaTime(1.0 / targetFps), 
-        m_lastTime(clock::now())
+    Counter() :
+        m_lastTime(clock::now()),
+        m_lastFrameTime(m_lastTime)
     {}
 
     void update()
@@ -18,10 +18,10 @@ public:
         ++m_frameCount;
         const auto currentTime = clock::now();
         const std::chrono::duration<double> elapsed = currentTime - m_lastTime;
+        const std::chrono::duration<double> frameTime = currentTime - m_lastFrameTime;
+        m_lastFrameTime = currentTime;
 
-
-        const double rawDeltaTime = elapsed.count();
-        m_deltaTime = rawDeltaTime;
+        m_deltaTime = frameTime.count();
 
         if (elapsed >= std::chrono::seconds(1))
         {
@@ -32,12 +32,14 @@ public:
     }
 
     [[nodiscard]] uint32_t getFps() const { return m_fps; }
-    [[nodiscard]] double getDeltaTime() const { return std::min(m_targetDeltaTime, m_deltaTime); }
+
+    // Unclamped time since the previous update
+    [[nodiscard]] double getFrameTime() const { return m_deltaTime; }
 
 private:
-    double m_targetDeltaTime;
     uint32_t m_frameCount{};
     clock::time_point m_lastTime;
+    clock::time_point m_lastFrameTime;
     uint32_t m_fps{};
     double m_deltaTime{};
 };
@@ -0,0 +1,62 @@
+#include "EmbeddedLevels.h"
+#include "GameBoard.h"
+
+namespace
+{
+    // Same layout as start.txt, kept by hand; run `TilePuzzle start.txt` to edit it with hot reload
+    constexpr std::string_view START_TEXT = R"(5,5
+Grass,Grass,Grass,Grass,Grass
+Grass,Grass,Grass,Grass,Grass
+Grass,Grass,Grass,Grass,Grass
+Grass,Grass,Grass,Grass,Grass
+Grass,Grass,Grass,Grass,Grass
+
+Empty,Empty,Empty,Empty,Empty
+Empty,Empty,Empty,Empty,Empty
+Empty,Empty,Empty,Empty,Empty
+Empty,Empty,Empty,Empty,Empty
+Empty,Empty,Empty,Empty,Empty
+
+Empty,Empty,Empty,Empty,Empty
+Empty,Rock,Empty,Empty,Empty
+Empty,Empty,Empty,Rock,Empty
+Empty,Empty,Empty,Empty,Empty
+Empty,Empty,Empty,Rock,Empty
+)";
+    constexpr EmbeddedLevels::Dimensions START_DIMENSIONS = EmbeddedLevels::parseDimensions(START_TEXT);
+    constexpr auto START = EmbeddedLevels::parse<START_DIMENSIONS.rows, START_DIMENSIONS.columns>(START_TEXT);
+
+    constexpr EmbeddedLevels::Level LEVELS[] = {
+        { "start", START_DIMENSIONS.rows, START_DIMENSIONS.columns, START.tiles.data(), START.immovables.data(), START.movables.data() },
+    };
+
+    static_assert(EmbeddedLevels::MAX_ROWS == GameBoard::MAX_ROWS && EmbeddedLevels::MAX_COLUMNS == GameBoard::MAX_COLUMNS,
+        "Embedded levels are limited like level files");
+}
+
+const EmbeddedLevels::Level* EmbeddedLevels::find(const std::string_view path)
+{
+    if (!isEmbedded(path))
+        return nullptr;
+
+    const std::string_view name = path.substr(PREFIX.size());
+    for (const Level& level : LEVELS)
+    {
+        if (level.name == name)
+            return &level;
+    }
+    return nullptr;
+}
+
+LevelLayers EmbeddedLevels::toLayers(const Level& level)
+{
+    // TEXTURE_KEYS are interned first, so compiled ids are registry ids as they are
+    const size_t cells = static_cast<size_t>(level.rows) * level.columns;
+    LevelLayers layers;
+    layers.rows = level.rows;
+    layers.columns = level.columns;
+    layers.tiles.assign(level.tiles, level.tiles + cells);
+    layers.immovables.assign(level.immovables, level.immovables + cells);
+    layers.movables.assign(level.movables, level.movables + cells);
+    return layers;
+}
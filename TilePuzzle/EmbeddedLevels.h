@@ -0,0 +1,153 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+#include "LevelData.h"
+#include "TextureKeys.h"
+
+/**
+ * @brief Levels compiled into the binary, loaded by path as "builtin:<name>" without I/O or parsing.
+ * Their text is parsed by constexpr functions into static tables of asset ids. Loading one still
+ * copies its tables into LevelLayers (see toLayers), so it isn't allocation-free. Malformed text or
+ * a key outside TEXTURE_KEYS fails the build: the parser throws, which is not a constant expression, and the
+ * compiler reports the throw along with its message.
+ */
+class EmbeddedLevels
+{
+public:
+    static constexpr std::string_view PREFIX = "builtin:";
+    static constexpr int MAX_ROWS = 256;         // Same as GameBoard's, which explains the limit
+    static constexpr int MAX_COLUMNS = 256;
+
+    struct Dimensions
+    {
+        int rows{};
+        int columns{};
+    };
+
+    /**
+     * @brief Ids of each layer, [row * columns + column] with rows as in the level file.
+     */
+    template <int Rows, int Columns>
+    struct Table
+    {
+        std::array<AssetId, static_cast<size_t>(Rows) * Columns> tiles{};
+        std::array<AssetId, static_cast<size_t>(Rows) * Columns> immovables{};
+        std::array<AssetId, static_cast<size_t>(Rows) * Columns> movables{};
+    };
+
+    /**
+     * @brief A built-in level; the layers point into its static Table.
+     */
+    struct Level
+    {
+        std::string_view name;
+        int rows{};
+        int columns{};
+        const AssetId* tiles{};
+        const AssetId* immovables{};
+        const AssetId* movables{};
+    };
+
+    [[nodiscard]] static constexpr bool isEmbedded(const std::string_view path) { return path.starts_with(PREFIX); }
+
+    /**
+     * @return the level at "builtin:<name>", nullptr for any other path
+     */
+    [[nodiscard]] static const Level* find(std::string_view path);
+
+    /**
+     * @brief Copies a level into layers for GameBoard, which keeps them to diff hot reloads against.
+     * Allocates the three layer vectors, rows * columns ids each.
+     */
+    [[nodiscard]] static LevelLayers toLayers(const Level& level);
+
+    [[nodiscard]] static constexpr Dimensions parseDimensions(const std::string_view text)
+    {
+        size_t position = 0;
+        const std::string_view line = nextLine(text, position);
+        const size_t comma = line.find(',');
+        check(comma != std::string_view::npos, "Level dimensions must be rows,columns");
+
+        const Dimensions dimensions{ parseInt(line.substr(0, comma)), parseInt(line.substr(comma + 1)) };
+        check(dimensions.rows > 0 && dimensions.columns > 0 && dimensions.rows <= MAX_ROWS && dimensions.columns <= MAX_COLUMNS,
+            "Level dimensions out of range");
+        return dimensions;
+    }
+
+    /**
+     * @param text level file contents whose first line matches Rows,Columns
+     */
+    template <int Rows, int Columns>
+    [[nodiscard]] static constexpr Table<Rows, Columns> parse(const std::string_view text)
+    {
+        const Dimensions dimensions = parseDimensions(text);
+        check(dimensions.rows == Rows && dimensions.columns == Columns, "Table size differs from the level dimensions");
+
+        Table<Rows, Columns> table;
+        size_t position = 0;
+        nextLine(text, position);
+        for (auto* layer : { &table.tiles, &table.immovables, &table.movables })
+        {
+            for (int row = 0; row < Rows; ++row)
+            {
+                // Blank lines separate layers
+                std::string_view line;
+                while (line.empty())
+                {
+                    check(position < text.size(), "Unexpected end of level in matrix data");
+                    line = nextLine(text, position);
+                }
+
+                int column = 0;
+                for (size_t start = 0;; ++column)
+                {
+                    const size_t comma = line.find(',', start);
+                    const size_t id = findTextureId(line.substr(start, comma == std::string_view::npos ? std::string_view::npos : comma - start));
+                    check(column < Columns, "Row size mismatch in matrix data");
+                    check(id < TEXTURE_KEYS.size(), "Unknown texture key in level");
+                    check(layer != &table.tiles || id != EMPTY_ASSET, "Every cell needs a tile");
+                    (*layer)[static_cast<size_t>(row) * Columns + column] = static_cast<AssetId>(id);
+                    if (comma == std::string_view::npos)
+                        break;
+                    start = comma + 1;
+                }
+                check(column + 1 == Columns, "Row size mismatch in matrix data");
+            }
+        }
+
+        while (position < text.size())
+            check(nextLine(text, position).empty(), "Unexpected data after the last layer");
+        return table;
+    }
+
+private:
+    static constexpr void check(const bool condition, const char* message)
+    {
+        if (!condition)
+            throw std::runtime_error(message);
+    }
+
+    static constexpr std::string_view nextLine(const std::string_view text, size_t& position)
+    {
+        const size_t end = text.find('\n', position);
+        std::string_view line = text.substr(position, end == std::string_view::npos ? std::string_view::npos : end - position);
+        position = end == std::string_view::npos ? text.size() : end + 1;
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        return line;
+    }
+
+    static constexpr int parseInt(const std::string_view digits)
+    {
+        check(!digits.empty() && digits.size() <= 6, "Expected a number");
+        int value = 0;
+        for (const char digit : digits)
+        {
+            check(digit >= '0' && digit <= '9', "Expected a number");
+            value = value * 10 + (digit - '0');
+        }
+        return value;
+    }
+};
@@ -0,0 +1,170 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+
+/**
+ * @brief Typed event bus that queues events during the frame and delivers them in batches.
+ * publish() may be called from any thread and never allocates: events go into a bounded lock-free
+ * ring (Vyukov's sequence-numbered MPMC queue, drained by one consumer). dispatch() is called once
+ * per frame on the main thread; it sorts the ring into one array per event type and calls every
+ * handler once per type with the whole batch, through a plain function pointer.
+ */
+template <size_t Capacity, typename... Events>
+class EventBus
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert((std::is_trivially_copyable_v<Events> && ...), "Events are copied through the ring");
+
+public:
+    static constexpr size_t MAX_HANDLERS = 8;
+
+    template <typename Event>
+    using Handler = void (*)(void* context, const Event* events, size_t count);
+
+    EventBus()
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    /**
+     * @return false if the ring is full; the event is dropped and counted
+     */
+    template <typename Event>
+    bool publish(const Event& event)
+    {
+        size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true)
+        {
+            slot = &m_slots[position & (Capacity - 1)];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0)
+            {
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                position = m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->event.template emplace<Event>(event);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Main thread only, outside dispatch().
+     * @throws std::length_error if the event type already has MAX_HANDLERS handlers
+     */
+    template <typename Event>
+    void subscribe(void* context, const Handler<Event> handler)
+    {
+        Batch<Event>& batch = std::get<Batch<Event>>(m_batches);
+        if (batch.handlerCount == MAX_HANDLERS)
+            throw std::length_error("Too many event handlers");
+        batch.handlers[batch.handlerCount++] = { context, handler };
+    }
+
+    /**
+     * @brief Removes every handler registered with context. Main thread only, outside dispatch().
+     */
+    void unsubscribe(const void* context)
+    {
+        std::apply([context](auto&... batches) { (batches.remove(context), ...); }, m_batches);
+    }
+
+    /**
+     * @brief Delivers everything published before the call. Events published by handlers are
+     * delivered by the next dispatch.
+     */
+    void dispatch()
+    {
+        size_t drained = 0;
+        while (drained < Capacity)
+        {
+            Slot& slot = m_slots[m_dequeuePosition & (Capacity - 1)];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != m_dequeuePosition + 1)
+                break;
+
+            std::visit([this](const auto& event)
+            {
+                Batch<std::decay_t<decltype(event)>>& batch = std::get<Batch<std::decay_t<decltype(event)>>>(m_batches);
+                batch.events[batch.count++] = event;
+            }, slot.event);
+
+            slot.sequence.store(m_dequeuePosition + Capacity, std::memory_order_release);
+            ++m_dequeuePosition;
+            ++drained;
+        }
+
+        std::apply([](auto&... batches) { (batches.deliver(), ...); }, m_batches);
+    }
+
+    [[nodiscard]] size_t getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence{};
+        std::variant<Events...> event;
+    };
+
+    template <typename Event>
+    struct Batch
+    {
+        struct Entry
+        {
+            void* context{};
+            Handler<Event> function{};
+        };
+
+        std::array<Event, Capacity> events{};
+        size_t count{};
+        std::array<Entry, MAX_HANDLERS> handlers{};
+        size_t handlerCount{};
+
+        void deliver()
+        {
+            if (count == 0)
+                return;
+            for (size_t i = 0; i < handlerCount; ++i)
+                handlers[i].function(handlers[i].context, events.data(), count);
+            count = 0;
+        }
+
+        void remove(const void* context)
+        {
+            size_t kept = 0;
+            for (size_t i = 0; i < handlerCount; ++i)
+            {
+                if (handlers[i].context != context)
+                    handlers[kept++] = handlers[i];
+            }
+            handlerCount = kept;
+        }
+    };
+
+    std::array<Slot, Capacity> m_slots;
+    alignas(64) std::atomic<size_t> m_enqueuePosition{ 0 };
+    alignas(64) size_t m_dequeuePosition{ 0 };
+    std::atomic<size_t> m_dropped{ 0 };
+    std::tuple<Batch<Events>...> m_batches;
+};
@@ -1,6 +1,6 @@
 #include "Game.h"
 
-Game::Game(SDL_Window* window, const std::string& levelPath) : m_window(window)
+Game::Game(SDL_Window* window, const std::string& levelPath) : Observer(&m_eventBus), m_window(window)
 {
     // Initialize SDL
     if (SDL_Init(SDL_INIT_VIDEO) < 0)
@@ -10,13 +10,43 @@ Game::Game(SDL_Window* window, const std::string& levelPath) : m_window(window)
     if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
         throw SDLInitException(SDL_GetError());
 
-    m_renderer = std::make_unique<Renderer>(m_window, -1, SDL_RENDERER_ACCELERATED);
+    m_renderer = std::make_unique<Renderer>(m_window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
     SDL_SetRenderDrawBlendMode(m_renderer->getRenderer(), SDL_BLENDMODE_BLEND);
 
+    Vector2<int> windowDimensions;
+    SDL_GetWindowSize(m_window, &windowDimensions.x, &windowDimensions.y);
+    m_camera = std::make_unique<Camera>(windowDimensions);
+    m_renderer->setCamera(m_camera.get());
+    m_tileLayer = std::make_unique<TileChunkLayer>(m_renderer->getRenderer());
+    TextureResidency::getInstance().setBudget(TEXTURE_BUDGET_BYTES);
+    AssetCache::getInstance().setPixelFormat(getNativePixelFormat());
+
+    // Optional; sprites missing from the atlas keep their own textures
+    if (SpriteAtlas::getInstance().load(SpriteAtlas::DEFAULT_PATH, m_renderer->getRenderer()))
+        std::cout << "Using sprite atlas " << SpriteAtlas::DEFAULT_PATH << "\n";
+
+    subscribe<TilePushed, &Game::onTilePushed>();
+    subscribe<LevelSolved, &Game::onLevelSolved>();
+
     // Load the level requested by WindowLoader
     loadLevel(levelPath);
 }
 
+uint32_t Game::getNativePixelFormat() const
+{
+    // The first format listed is the one the renderer uploads without converting
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(m_renderer->getRenderer(), &info) == 0)
+    {
+        for (Uint32 i = 0; i < info.num_texture_formats; ++i)
+        {
+            if (SDL_BYTESPERPIXEL(info.texture_formats[i]) == 4 && !SDL_ISPIXELFORMAT_FOURCC(info.texture_formats[i]))
+                return info.texture_formats[i];
+        }
+    }
+    return SDL_PIXELFORMAT_ARGB8888;
+}
+
 void Game::loadLevel(const std::string& path)
 {
     std::cout << "load player\n";
@@ -24,38 +54,237 @@ void Game::loadLevel(const std::string& path)
     addForegroundEntity(m_player);
 
     // Load level-specific resources
-    m_gameBoard = std::make_unique<GameBoard>(path, m_player, m_renderer->getRenderer());
+    m_gameBoard = std::make_unique<GameBoard>(path, m_player, m_renderer->getRenderer(), &m_eventBus);
 
-    // Load general resources
+    // Tiles are drawn through the chunk layer
     for (auto& entity : m_gameBoard->getTiles())
-        addBackgroundEntity(entity);
+        entity->cacheTexture();
+    m_tileLayer->setTiles(m_gameBoard->getTileGrid());
+    m_gameBoard->clearDirtyTiles();
+
+    // Objects are drawn by the board's layer, found through the tiles they rest on
+    for (auto& entity : m_gameBoard->getObjects())
+        entity->cacheTexture();
+
+    m_levelPath = path;
+    m_pushCount = 0;
+    m_levelWatcher = EmbeddedLevels::isEmbedded(path) ? nullptr : std::make_unique<LevelWatcher>(path);
+    m_hintSolver.request(m_gameBoard->captureSnapshot());
+
+    // Levels that start solved, e.g. without goals, aren't announced
+    m_isSolved = m_gameBoard->isSolved();
+}
+
+void Game::reloadLevel()
+{
+    try
+    {
+        const auto start = Counter::clock::now();
+
+        // Only the rebuilt cells need textures, everything else keeps its cache
+        const int rows = m_gameBoard->getBoardRows();
+        const int columns = m_gameBoard->getBoardColumns();
+        const std::vector<std::shared_ptr<Entity>> rebuilt = m_gameBoard->reload(m_levelPath);
+        for (const auto& entity : rebuilt)
+            entity->cacheTexture();
+
+        std::vector<std::shared_ptr<Tile>> tiles;
+        for (const auto& entity : rebuilt)
+        {
+            if (auto tile = std::dynamic_pointer_cast<Tile>(entity))
+                tiles.push_back(std::move(tile));
+        }
+
+        // Unless every tile was replaced, the chunks keep their textures and recompose just the new tiles
+        if (rows != m_gameBoard->getBoardRows() || columns != m_gameBoard->getBoardColumns() ||
+            tiles.size() == m_gameBoard->getTileGrid().size())
+            collectEntities();
+        else
+        {
+            for (const auto& tile : tiles)
+            {
+                const Vector2<int> cell = TileGeometry::toBoardCoordinates(tile->getWindowCoordinates());
+                m_tileLayer->setTile(cell.x, cell.y, tile);
+            }
+        }
+        m_isSolved = m_gameBoard->isSolved();
+        m_hintSolver.request(m_gameBoard->captureSnapshot());
+
+        const std::chrono::duration<double, std::milli> elapsed = Counter::clock::now() - start;
+        std::cout << "Reloaded " << m_levelPath << ": " << rebuilt.size() << " entities rebuilt in " << elapsed.count() << " ms\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Level reload failed, keeping current board: " << e.what() << "\n";
+    }
+}
+
+double Game::save(const std::string& path)
+{
+    const auto start = Counter::clock::now();
+    m_saveWriter.submit(m_gameBoard->captureSaveState(m_levelPath), path);
+    const std::chrono::duration<double, std::milli> elapsed = Counter::clock::now() - start;
+    return elapsed.count();
+}
+
+void Game::loadSave(const std::string& path)
+{
+    try
+    {
+        const auto start = Counter::clock::now();
+        m_saveWriter.flush();
+        const SaveFile save(path);
+        if (save.getLevelPath() != m_levelPath)
+            throw std::runtime_error("Save is of " + std::string(save.getLevelPath()) + ", not " + m_levelPath);
+
+        m_gameBoard->restore(save);
+        m_isSolved = m_gameBoard->isSolved();
+        m_hintSolver.request(m_gameBoard->captureSnapshot());
+
+        const std::chrono::duration<double, std::milli> elapsed = Counter::clock::now() - start;
+        std::cout << "Loaded " << path << " in " << elapsed.count() << " ms\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Couldn't load " << path << ", keeping current board: " << e.what() << "\n";
+    }
+}
+
+void Game::collectEntities()
+{
+    m_tileLayer->setTiles(m_gameBoard->getTileGrid());
+    m_gameBoard->clearDirtyTiles();
+
+    m_foregroundEntities.clear();
+    m_foregroundEntities.push_back(m_player);
 }
 
 void Game::run()
 {
-    Counter counter(60);
+    Counter counter;
     bool alive = true;
+    double accumulator = 0.0;
 
     while (alive)
     {
-        alive = handleInputEvents();
+        const auto frameStart = Counter::clock::now();
+        AllocationTracker::beginFrame();
+        TextureResidency::getInstance().beginFrame();
+        RenderStatistics::beginFrame();
+        {
+            AllocationTracker::Scope scope(AllocationCategory::Input);
+            alive = handleInputEvents();
+        }
+        bool steady = !m_hadInput;
+        if (m_levelWatcher && m_levelWatcher->poll())
+        {
+            reloadLevel();
+            steady = false;
+        }
         counter.update();
-        update(counter.getDeltaTime());
-        m_renderer->renderInLayers(m_backgroundEntities, m_foregroundEntities);
+        const auto updateStart = Counter::clock::now();
+
+        {
+            AllocationTracker::Scope scope(AllocationCategory::Pathfinding);
+            m_gameBoard->planMovers();
+        }
+
+        // Simulate in fixed steps, then draw in between the last two
+        accumulator += std::min(counter.getFrameTime(), MAX_FRAME_TIME);
+        {
+            AllocationTracker::Scope scope(AllocationCategory::BoardUpdate);
+            while (accumulator >= FIXED_TIMESTEP)
+            {
+                update(FIXED_TIMESTEP);
+                accumulator -= FIXED_TIMESTEP;
+            }
+        }
+        m_renderer->setInterpolation(accumulator / FIXED_TIMESTEP);
+
+        // Everything the steps above published, in one batch per event type
+        m_eventBus.dispatch();
+
+        for (const Vector2<int>& tile : m_gameBoard->getDirtyTiles())
+            m_tileLayer->markDirty(tile.x, tile.y);
+        m_gameBoard->clearDirtyTiles();
+        const auto renderStart = Counter::clock::now();
+        {
+            AllocationTracker::Scope scope(AllocationCategory::Render);
+            m_renderer->clear();
+            m_renderer->renderInLayers(*m_tileLayer, *m_gameBoard, m_foregroundEntities, m_perfOverlay);
+        }
+        const auto renderEnd = Counter::clock::now();
+        m_latencyTracker.onPresent();
+
+        // Shown on the next frame; the split covers this one up to the present
+        PerfOverlay::Sample sample;
+        sample.frameTime = counter.getFrameTime() * 1000.0;
+        sample.inputTime = std::chrono::duration<double, std::milli>(updateStart - frameStart).count();
+        sample.updateTime = std::chrono::duration<double, std::milli>(renderStart - updateStart).count();
+        sample.renderTime = std::chrono::duration<double, std::milli>(renderEnd - renderStart).count();
+        sample.pathQueryTime = m_gameBoard->getLastPathQueryTime();
+        sample.fps = counter.getFps();
+        sample.drawCalls = RenderStatistics::getFrame().drawCalls;
+        sample.textureSwitches = RenderStatistics::getFrame().textureSwitches;
+        sample.residentBytes = TextureResidency::getInstance().getStatistics().residentBytes;
+        sample.filledGoals = m_gameBoard->getFilledGoalCount();
+        sample.goalCount = m_gameBoard->getGoalCount();
+        sample.pushes = m_pushCount;
+        sample.solved = m_isSolved;
+        m_perfOverlay.record(sample);
         SDL_UpdateWindowSurface(m_window);
+        AllocationTracker::endFrame(steady);
     }
 }
 
 bool Game::handleInputEvents()
 {
+    m_hadInput = false;
     while (SDL_PollEvent(&m_windowEvent) > 0)
     {
+        m_hadInput = true;
         switch (m_windowEvent.type)
         {
         case SDL_QUIT:
             return false;
 
+        case SDL_KEYDOWN:
+            if (m_windowEvent.key.keysym.sym == SDLK_F9)
+                m_latencyTracker.report(std::cout);
+            else if (m_windowEvent.key.keysym.sym == SDLK_F10)
+                AllocationTracker::report(std::cout);
+            else if (m_windowEvent.key.keysym.sym == SDLK_F3)
+                m_perfOverlay.toggle();
+            else if (m_windowEvent.key.keysym.sym == SDLK_F5)
+                std::cout << "Saving " << AUTOSAVE_PATH << ", " << save(AUTOSAVE_PATH) << " ms on the main thread\n";
+            else if (m_windowEvent.key.keysym.sym == SDLK_F6)
+                loadSave(AUTOSAVE_PATH);
+            else if (m_windowEvent.key.keysym.sym == SDLK_HOME)
+                m_camera->reset();
+            break;
+
+        case SDL_MOUSEMOTION:
+            // Drag with the right button to pan
+            if (m_windowEvent.motion.state & SDL_BUTTON_RMASK)
+                m_camera->pan({ static_cast<double>(m_windowEvent.motion.xrel), static_cast<double>(m_windowEvent.motion.yrel) });
+            break;
+
+        case SDL_MOUSEWHEEL:
+        {
+            Vector2<int> mousePosition;
+            SDL_GetMouseState(&mousePosition.x, &mousePosition.y);
+            if (m_windowEvent.wheel.y != 0)
+                m_camera->zoomAt(mousePosition, m_windowEvent.wheel.y > 0 ? ZOOM_STEP : 1.0 / ZOOM_STEP);
+            break;
+        }
+
+        case SDL_RENDER_TARGETS_RESET:
+        case SDL_RENDER_DEVICE_RESET:
+            m_tileLayer->invalidate();
+            break;
+
         case SDL_MOUSEBUTTONDOWN:
+            m_gameState.inputTime = LatencyTracker::fromEventTimestamp(m_windowEvent.button.timestamp);
             if (m_windowEvent.button.button == SDL_BUTTON_LEFT)
                 handleLeftMouseButtonClick(m_windowEvent.button);
 
@@ -72,7 +301,9 @@ bool Game::handleInputEvents()
 
 void Game::handleLeftMouseButtonClick(const SDL_MouseButtonEvent& event)
 {
-	m_gameBoard->onClick(m_gameState);
+    // The hint and autosave wait for the push itself, which comes once the player has walked up to the block
+    if (m_gameBoard->onClick(m_gameState))
+        m_latencyTracker.markPending(m_gameState.inputTime);
 }
 
 void Game::handleRightMouseButtonClick(const SDL_MouseButtonEvent& event)
@@ -84,20 +315,37 @@ void Game::update(const double deltaTime)
 {
     Vector2<int> mousePosition;
     SDL_GetMouseState(&mousePosition.x, &mousePosition.y);
-    m_gameState.mousePosition = mousePosition;
+    m_gameState.mousePosition = m_camera->screenToWorld(mousePosition);
     m_gameState.deltaTime = deltaTime;
     //std::cout << mousePosition << "\r";
     m_gameBoard->update(m_gameState);
 
-    // Check if the game has finished
-    //if (m_tileMap->isSolved())
-        //std::cout << "Game finished!\n";
+    // Hints for an older board version are dropped by showHint
+    while (const std::optional<Hint> hint = m_hintSolver.poll())
+        m_gameBoard->showHint(*hint);
+
+    // O(1) now, so it's checked every step; only the transition is announced
+    const bool solved = m_gameBoard->isSolved();
+    if (solved && !m_isSolved)
+        publish(LevelSolved{ m_gameBoard->getSnapshotVersion(), m_gameBoard->getOccupancyHash() });
+    m_isSolved = solved;
 }
 
-void Game::addBackgroundEntity(const std::shared_ptr<Entity>& entity)
+void Game::onTilePushed(const TilePushed*, const size_t count)
 {
-    entity->cacheTexture();
-    m_backgroundEntities.push_back(entity);
+    m_pushCount += static_cast<uint32_t>(count);
+
+    // One request and one save for every push this frame, against the board they left
+    AllocationTracker::ExpectedScope expected;
+    m_hintSolver.request(m_gameBoard->captureSnapshot());
+    save(AUTOSAVE_PATH);
+}
+
+void Game::onLevelSolved(const LevelSolved*, size_t)
+{
+    // Nothing is left to hint at; pushing a block off a goal requests a hint again
+    m_gameBoard->clearHint();
+    m_hintSolver.cancel();
 }
 
 void Game::addForegroundEntity(const std::shared_ptr<Entity>& entity)
@@ -108,6 +356,27 @@ void Game::addForegroundEntity(const std::shared_ptr<Entity>& entity)
 
 Game::~Game()
 {
+    // The bus is a member, so it is gone before ~Observer runs
+    detachEventBus();
+
+    m_latencyTracker.report(std::cout);
+    if (AllocationTracker::ENABLED)
+        AllocationTracker::report(std::cout);
+    const TextureResidency::Statistics& textures = TextureResidency::getInstance().getStatistics();
+    std::cout << "Textures: " << textures.peakResidentBytes / 1024 << " KiB peak resident, "
+        << textures.uploads << " uploads, " << textures.reuploads << " re-uploads, "
+        << textures.evictions << " evictions\n";
+    const AssetCache::Statistics& assets = AssetCache::getInstance().getStatistics();
+    std::cout << "Asset cache: " << assets.hits << " hits, " << assets.misses << " misses\n";
+
+    // Sprites free their textures as they go, so they must go before the renderer that made them
+    m_gameBoard.reset();
+    m_foregroundEntities.clear();
+    m_mouse.reset();
+    m_player.reset();
+    m_tileLayer.reset();
+    SpriteAtlas::getInstance().unload();
+    m_renderer.reset();
     SDL_DestroyWindow(m_window);
     SDL_Quit();
 }
@@ -14,8 +14,19 @@
 #include "Vector2.h"
 #include "Player.h"
 #include "Renderer.h"
+#include "Camera.h"
+#include "TileChunkLayer.h"
+#include "SpriteAtlas.h"
+#include "AssetCache.h"
+#include "AllocationTracker.h"
 #include "GameBoard.h"
 #include "GameState.h"
+#include "LevelWatcher.h"
+#include "EmbeddedLevels.h"
+#include "LatencyTracker.h"
+#include "SaveGame.h"
+#include "PerfOverlay.h"
+#include "RenderStatistics.h"
 
 class Game final : public Observer
 {
@@ -26,25 +37,58 @@ public:
     void handleLeftMouseButtonClick(const SDL_MouseButtonEvent& event);
     void handleRightMouseButtonClick(const SDL_MouseButtonEvent& event);
     void update(double deltaTime);
-    void addBackgroundEntity(const std::shared_ptr<Entity>& entity);
     void addForegroundEntity(const std::shared_ptr<Entity>& entity);
     void loadLevel(const std::string& path);
+    void reloadLevel();
+
+    /**
+     * @brief Captures the board on this thread and hands it to the save writer.
+     * @return milliseconds spent on this thread
+     */
+    double save(const std::string& path);
+
+    /**
+     * @brief Waits for pending saves, then restores the board. Failures keep the current board.
+     */
+    void loadSave(const std::string& path);
 
     /**
      * @return false - user quit
      */
     bool handleInputEvents();
+
+    static constexpr size_t TEXTURE_BUDGET_BYTES = 64ull * 1024 * 1024;
+    static constexpr double FIXED_TIMESTEP = 1.0 / 120.0;
+    static constexpr double MAX_FRAME_TIME = 0.25;               // Drop time beyond this rather than spiral
+    static constexpr double ZOOM_STEP = 1.1;                     // Zoom factor per mouse wheel notch
+    static constexpr const char* AUTOSAVE_PATH = "./saves/autosave.tps";  // Written after every push, F5; read by F6
     //bool canMoveTo(const Entity& entity, Vector2<double> potentialPosition) const override;
 
 private:
+    void collectEntities();
+    void onTilePushed(const TilePushed* events, size_t count);
+    void onLevelSolved(const LevelSolved* events, size_t count);
+    [[nodiscard]] uint32_t getNativePixelFormat() const;
+
+    GameEventBus m_eventBus;                                     // Detached in ~Game, before members are destroyed
     GameState m_gameState;
+    bool m_isSolved = false;
+    uint32_t m_pushCount{};                                      // Since the level was loaded, for the HUD
+    bool m_hadInput = false;                                     // Any event this frame; such frames may allocate
+    std::string m_levelPath;
+    std::unique_ptr<LevelWatcher> m_levelWatcher;
+    LatencyTracker m_latencyTracker;
+    PerfOverlay m_perfOverlay;                                   // Toggled with F3
+    HintSolver m_hintSolver;
+    SaveWriter m_saveWriter;
     std::unique_ptr<GameBoard> m_gameBoard;
-    std::vector<std::shared_ptr<Entity>> m_backgroundEntities;
     std::vector<std::shared_ptr<Entity>> m_foregroundEntities;
     std::shared_ptr<Sprite> m_mouse;
     std::shared_ptr<Player> m_player;
     SDL_Window* m_window{};                                      // SDL window instance
     SDL_Event m_windowEvent{};                                   // SDL event for window handling
     std::unique_ptr<Renderer> m_renderer;
+    std::unique_ptr<Camera> m_camera;
+    std::unique_ptr<TileChunkLayer> m_tileLayer;                 // Destroyed before the renderer it draws with
     std::atomic<bool> m_isAlive{ true };
 };
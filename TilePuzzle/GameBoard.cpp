@@ -2,10 +2,31 @@
 #include <iostream>
 #include <cmath>
 #include <iomanip>
+#include <chrono>
 #include "Factory.h"
+#include "AssetCache.h"
+#include "EmbeddedLevels.h"
+#include "AllocationTracker.h"
 #include "Player.h"
 #include <iostream>
 
+namespace
+{
+    /**
+     * @brief Stores the milliseconds until the end of the scope.
+     */
+    class QueryTimer
+    {
+    public:
+        explicit QueryTimer(double& milliseconds) : m_milliseconds(milliseconds), m_start(std::chrono::steady_clock::now()) {}
+        ~QueryTimer() { m_milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count(); }
+
+    private:
+        double& m_milliseconds;
+        std::chrono::steady_clock::time_point m_start;
+    };
+}
+
 inline bool operator==(const SDL_Color first, const SDL_Color second) noexcept
 {
     return first.r == second.r &&
@@ -19,17 +40,6 @@ inline bool operator!=(const SDL_Color first, const SDL_Color second) noexcept
     return !(first == second);
 }
 
-SDL_Color SpriteModifier::toSdlColor() const
-{
-    return
-    {
-        colorClamp(r),
-        colorClamp(g),
-        colorClamp(b),
-        colorClamp(a)
-    };
-}
-
 Sprite::Sprite(const char* path, SDL_Renderer* cacheRenderer, const Observer* observer)
     : m_renderFlag(true), m_observer(observer), m_cacheRenderer(cacheRenderer)
 {
@@ -37,6 +47,7 @@ Sprite::Sprite(const char* path, SDL_Renderer* cacheRenderer, const Observer* ob
     m_surface = loadSurface(path);
     m_rect.w = m_surface->w;
     m_rect.h = m_surface->h;
+    m_stateTextures = StateTextureCache::acquire(path, cacheRenderer);
 }
 
 Sprite::Sprite(const SDL_Rect rect, const SDL_Color color, SDL_Renderer* cacheRenderer, const Observer* observer)
@@ -60,7 +71,10 @@ Sprite::Sprite(const Sprite& other)
       m_rect(other.m_rect),
       m_coordinates(other.m_coordinates),
       m_observer(other.m_observer),
-      m_cacheRenderer(other.m_cacheRenderer)
+      m_cacheRenderer(other.m_cacheRenderer),
+      m_stateTextures(other.m_stateTextures),
+      m_state(other.m_state),
+      m_restingState(other.m_restingState)
 {
     m_surfaceOriginal = SDL_ConvertSurface(other.m_surface, other.m_surface->format, 0);
     m_surface = SDL_ConvertSurface(other.m_surface, other.m_surface->format, 0);
@@ -70,6 +84,7 @@ Sprite::Sprite(const Sprite& other)
 
 Sprite::~Sprite()
 {
+    releaseCachedTextures(0);
     SDL_FreeSurface(m_surface);
     SDL_FreeSurface(const_cast<SDL_Surface*>(m_surfaceOriginal)); // Cast away const for freeing
 }
@@ -132,15 +147,33 @@ SDL_Surface* Sprite::getSdlSurface() const
 
 SDL_Texture* Sprite::getCachedTexture() const
 {
-    return m_texture;
+    // Ad-hoc modifiers still go through the per-instance variants
+    const size_t depth = m_modifierStack.size();
+    if (m_stateTextures && depth == 0)
+        return m_stateTextures->get(m_state);
+    if (depth < m_cachedTextures.size())
+        return TextureResidency::getInstance().acquire(m_cachedTextures[depth]);
+    return nullptr;
+}
+
+const SDL_Rect* Sprite::getSourceRect() const
+{
+    if (m_stateTextures && m_modifierStack.empty())
+        return m_stateTextures->getSourceRect(m_state);
+    return nullptr;
+}
+
+void Sprite::setRestingState(const SpriteState state)
+{
+    // Don't override a hover that is still in progress
+    if (m_state == m_restingState)
+        m_state = state;
+    m_restingState = state;
 }
 
 SDL_Surface* Sprite::loadSurface(const char* path)
 {
-    SDL_Surface* surface = SDL_LoadBMP(path);
-    if (!surface)
-        throw SDLImageLoadException(SDL_GetError());
-    return surface;
+    return AssetCache::getInstance().createSurface(path);
 }
 
 void Sprite::resetSurface()
@@ -151,38 +184,7 @@ void Sprite::resetSurface()
 
 void Sprite::applyModifier(const SpriteModifier& modifier)
 {
-    //const SpriteModifier deltaColor = SpriteModifier(offset) - m_rgbaOffset;
-    // Lock surface to access pixel data
-    if (SDL_LockSurface(m_surface) != 0)
-        return;
-    
-    auto* pixels = static_cast<uint32_t*>(m_surface->pixels); // Access pixel data
-
-    const int width = m_surface->w;
-    const int height = m_surface->h;
-
-    // Manipulate each pixel
-    for (int y = 0; y < height; ++y)
-    {
-        for (int x = 0; x < width; ++x)
-        {
-            const uint32_t pixel = pixels[y * width + x];
-            uint8_t r, g, b, a;
-            SDL_GetRGBA(pixel, m_surface->format, &r, &g, &b, &a);
-
-            // Apply offset and colorClamp operation to each color component
-            r = SpriteModifier::colorClamp(r + modifier.r);
-            g = SpriteModifier::colorClamp(g + modifier.g);
-            b = SpriteModifier::colorClamp(b + modifier.b);
-            a = SpriteModifier::colorClamp(a + modifier.a);
-
-            // Update pixel
-            pixels[y * width + x] = SDL_MapRGBA(m_surface->format, r, g, b, a);
-        }
-    }
-
-    // Unlock surface
-    SDL_UnlockSurface(m_surface);
+    modifier.applyTo(m_surface);
 }
 
 bool Sprite::hasCollisionWith(const Entity& other, 
@@ -321,45 +323,82 @@ void Sprite::printSlices()
 
 void Sprite::onFocus()
 {
-    pushModifier({"Cursor", 30, 30, 30, 0 });
+    if (m_stateTextures)
+        setState(SpriteState::Hovered);
+    else
+        pushModifier({"Cursor", 30, 30, 30, 0 });
 }
 
 void Sprite::onBlur()
 {
-    popModifier();
+    if (m_stateTextures)
+        restoreRestingState();
+    else
+        popModifier();
 }
 
 void GameObject::update(const GameState& state)
 {
-    if (!m_checkpoints.empty())
+    m_previousCoordinates = m_coordinates;
+    if (m_checkpoints.empty())
+        return;
+
+    double distance = m_speed * state.deltaTime;
+    Vector2<double> coordinates = m_coordinates;
+
+    while (m_nextCheckpoint < m_checkpoints.size())
     {
-        Vector2<double> target = m_checkpoints.front();
+        const Vector2<double> target = m_checkpoints[m_nextCheckpoint];
 
-        // Move horizontally if x coordinates are different
-        if (std::abs(target.x - getWindowCoordinates().x) > 1)
-        {
-            Vector2<double> coordinates = getWindowCoordinates();
-            const int sign = coordinates.x < target.x ? 1 : -1;
-            coordinates.x += m_speed * state.deltaTime * sign;
-            setCoordinates(coordinates);
-        }
+        // Move horizontally first, then vertically
+        double& axis = coordinates.x != target.x ? coordinates.x : coordinates.y;
+        const double axisTarget = coordinates.x != target.x ? target.x : target.y;
+        const double remaining = std::abs(axisTarget - axis);
 
-        // Move vertically if y coordinates are different
-        else if (std::abs(target.y - getWindowCoordinates().y) > 1) 
+        if (remaining <= distance)
         {
-            Vector2<double> coordinates = getWindowCoordinates();
-            const int sign = coordinates.y < target.y ? 1 : -1;
-            coordinates.y += m_speed * state.deltaTime * sign;
-            setCoordinates(coordinates);
+            axis = axisTarget;
+            distance -= remaining;
         }
-
-        // Reached the checkpoint
         else
         {
-            setCoordinates(target);
-            m_checkpoints.erase(m_checkpoints.begin());
+            axis += axis < axisTarget ? distance : -distance;
+            distance = 0;
         }
+
+        // Reached the checkpoint
+        if (coordinates == target)
+            ++m_nextCheckpoint;
+        else if (distance <= 0)
+            break;
     }
+
+    Sprite::setCoordinates(coordinates);
+
+    if (m_nextCheckpoint == m_checkpoints.size())
+    {
+        m_checkpoints.clear();
+        m_nextCheckpoint = 0;
+        if (m_state == SpriteState::Pushed)
+            restoreRestingState();
+        if (m_observer)
+            m_observer->publish(WalkFinished{ this, m_rect.x, m_rect.y });
+    }
+}
+
+void GameObject::setCoordinates(const Vector2<double> coordinates)
+{
+    // Placing an object directly is a teleport, not something to interpolate
+    Sprite::setCoordinates(coordinates);
+    m_previousCoordinates = coordinates;
+}
+
+SDL_Rect GameObject::getRenderRect(const double interpolation) const
+{
+    SDL_Rect rect = m_rect;
+    rect.x = static_cast<int>(std::lround(m_previousCoordinates.x + (m_coordinates.x - m_previousCoordinates.x) * interpolation));
+    rect.y = static_cast<int>(std::lround(m_previousCoordinates.y + (m_coordinates.y - m_previousCoordinates.y) * interpolation));
+    return rect;
 }
 
 void Sprite::pushModifier(const SpriteModifier& modifier)
@@ -375,7 +414,8 @@ void Sprite::removeModifier(const std::string& name)
         if (m_modifierStack[i].name == name)
         {
             m_modifierStack.erase(std::next(m_modifierStack.begin(), i));
-            m_cachedTextures.erase(std::next(m_cachedTextures.begin(), i));
+            // Variants above the removed modifier no longer match the stack
+            releaseCachedTextures(i + 1);
             break;
         }
     }
@@ -388,12 +428,8 @@ SpriteModifier Sprite::popModifier()
     {
         SpriteModifier topModifier = m_modifierStack.back();
         m_modifierStack.pop_back();
-        if (m_cachedTextures.size() > 1)
-        {
-            // Destroy the last cached texture
-            SDL_DestroyTexture(m_cachedTextures.back());
-            m_cachedTextures.pop_back();
-        }
+        // Drop the popped variant; the one below it stays cached
+        releaseCachedTextures(m_modifierStack.size() + 1);
         // Apply remaining modifiers in order
         applyModifiers();
         return topModifier;
@@ -404,6 +440,8 @@ SpriteModifier Sprite::popModifier()
 
 void Sprite::applyModifiers()
 {
+    AllocationTracker::Scope scope(AllocationCategory::Modifiers);
+
     // Start clean
      resetSurface();
 
@@ -418,15 +456,32 @@ void Sprite::applyModifiers()
 // Create a cached texture after applying all modifiers
 void Sprite::cacheTexture()
 {
-    if (m_texture != nullptr)
-        SDL_DestroyTexture(m_texture);
+    // Baked state textures already cover the unmodified sprite
+    if (m_stateTextures && m_modifierStack.empty())
+        return;
 
-    m_texture = SDL_CreateTextureFromSurface(m_cacheRenderer, m_surface);
-    if (!m_texture)
+    // m_cachedTextures[i] holds the variant with the first i modifiers applied
+    const size_t depth = m_modifierStack.size();
+    if (depth < m_cachedTextures.size() && m_cachedTextures[depth] != TextureResidency::INVALID_HANDLE)
+        return;
+
+    SDL_Surface* retained = SDL_DuplicateSurface(m_surface);
+    if (!retained)
         throw SDLImageLoadException(SDL_GetError());
 
-    // Cache this texture for future use
-    m_cachedTextures.push_back(m_texture);
+    releaseCachedTextures(depth);
+    m_cachedTextures.resize(depth, TextureResidency::INVALID_HANDLE);
+    m_cachedTextures.push_back(TextureResidency::getInstance().add(m_cacheRenderer, retained));
+}
+
+void Sprite::releaseCachedTextures(const size_t fromDepth)
+{
+    TextureResidency& residency = TextureResidency::getInstance();
+    while (m_cachedTextures.size() > fromDepth)
+    {
+        residency.release(m_cachedTextures.back());
+        m_cachedTextures.pop_back();
+    }
 }
 
 Tile::Tile(const std::string& texturePath,
@@ -438,18 +493,25 @@ Tile::Tile(const std::string& texturePath,
     m_isGoalTile(isGoalTile)
 {}
 
-void GameBoard::onClick(const GameState& state)
+bool GameBoard::onClick(const GameState& state)
 {
-    if (state.mousePosition.x > m_boardBounds.x || state.mousePosition.y > m_boardBounds.y)
-        return;
+    if (state.mousePosition.x < 0 || state.mousePosition.y < 0 ||
+        state.mousePosition.x > m_boardBounds.x || state.mousePosition.y > m_boardBounds.y)
+        return false;
 
     std::cout << "click\n";
+    m_playerRoute = {};
+    m_actions.cancel(m_playerAction);
+    m_playerAction = 0;
     const Vector2<int> destination = centerScreenCoordinates(state.mousePosition, m_player->getSdlRect());
     std::shared_ptr<Tile> tile = getEnclosingTile(destination);
 
     // Unoccupied destination tile
     if (tile->getResidingEntity() == nullptr)
     {
+        if (m_pathfindingMethod == PathfindingMethod::Hierarchical)
+            return startPlayerRoute(tile);
+
         std::vector<std::shared_ptr<Tile>> tiles = getPathToTile(getEnclosingTile(m_player->getWindowCoordinates()), tile);
         std::vector<Vector2<int>> path;
         path.reserve(tiles.size());
@@ -459,36 +521,38 @@ void GameBoard::onClick(const GameState& state)
                 m_player->getSdlRect())
             );
         m_player->walk(path);
+        if (path.empty())
+            return false;
+
+        editSnapshot().playerCell = getCellIndex(getGameBoardCoordinates(tiles.back()->getWindowCoordinates()));
+        return true;
     }
     
-    //FIXME: Go to a neighboring tile and push the slab
+    // Go to a neighboring tile, then push the slab; walls are no more a destination than they are pushable
     else
     {
+        const auto object = std::dynamic_pointer_cast<GameObject>(tile->getResidingEntity());
+        if (object && object->getPhysicsType() == GameObject::PhysicsType::Immovable)
+            return false;
+
         std::shared_ptr<Tile> nextTileChoice = getClosestAvailableTile(state.mousePosition, m_player->getWindowCoordinates());
         if (nextTileChoice)
         {
-            std::vector<std::shared_ptr<Tile>> tiles = getPathToTile(getEnclosingTile(m_player->getWindowCoordinates()), tile);
-            std::vector<Vector2<int>> path;
-            path.reserve(tiles.size());
-            for (const auto& i : tiles)
-                path.push_back(centerScreenCoordinates(i->getWindowCoordinates(), m_player->getSdlRect()));
-
-            m_player->walk(path);
-            pushTile(getEnclosingTile(destination)->getResidingEntity(), m_player->getWindowCoordinates());
+            m_playerAction = m_actions.start(walkAndPush(tile->getResidingEntity(), nextTileChoice));
+            return m_playerAction != 0;
         }
     }
     //m_hoverTracker.getFocused()->onClick();
+    return false;
 }
 
 void GameBoard::update(const GameState& state)
 {
     Vector2<int> mousePosition = state.mousePosition;
 
-    if (mousePosition.x > m_boardBounds.x)
-        mousePosition.x = m_boardBounds.x;
-
-    if (mousePosition.y > m_boardBounds.y)
-        mousePosition.y = m_boardBounds.y;
+    // The camera can show space around the board
+    mousePosition.x = std::clamp(mousePosition.x, 0, m_boardBounds.x);
+    mousePosition.y = std::clamp(mousePosition.y, 0, m_boardBounds.y);
 
     std::shared_ptr<Tile> hoveredTile = getEnclosingTile(mousePosition);
     std::shared_ptr<Entity> residingEntity = hoveredTile->getResidingEntity();
@@ -499,24 +563,63 @@ void GameBoard::update(const GameState& state)
             residingEntity->onFocus();
 
             if (m_hoveredEntity)
+            {
                 m_hoveredEntity->onBlur();
+                markDirty(m_hoveredEntity);
+            }
             m_hoveredEntity = residingEntity;
         }
     }
-    else
+    else if (hoveredTile != m_hoveredEntity)
     {
         hoveredTile->onFocus();
+        markDirty(hoveredTile);
         if (m_hoveredEntity)
+        {
             m_hoveredEntity->onBlur();
+            markDirty(m_hoveredEntity);
+        }
         m_hoveredEntity = hoveredTile;
     }
 
+    if (!m_playerRoute.isFinished() && m_player->getRemainingCheckpoints() <= REFINE_AHEAD)
+        continuePlayerRoute();
+
+    // Objects at rest have nothing to update, so only the moving ones are visited
     m_player->update(state);
+    std::erase_if(m_movingObjects, [&state](const std::shared_ptr<GameObject>& object)
+    {
+        object->update(state);
+        return !object->isMoving();
+    });
+
+    // After the objects moved, so a walk that just ended resumes its sequence this step
+    m_actions.update(state.deltaTime);
+
+    // Movers step one tile at a time in lockstep, as their reservations assume
+    if (!m_movers.empty())
+    {
+        m_moverClock += state.deltaTime;
+        while (m_moverClock >= MOVER_STEP_TIME)
+        {
+            m_moverClock -= MOVER_STEP_TIME;
+            for (const CooperativePlanner::AgentId mover : m_planner.advance())
+                m_movers[mover]->walkTo(getCellCenter(m_planner.getCell(mover), *m_movers[mover]));
+        }
+        for (const auto& mover : m_movers)
+            mover->update(state);
+    }
 }
 
 void Tile::setResidingEntity(const std::shared_ptr<Sprite>& residingEntity)
 {
+    const bool wasOccupied = m_residingEntity != nullptr;
     m_residingEntity = residingEntity;
+    if (m_occupancy && wasOccupied != (residingEntity != nullptr))
+        m_occupancy->toggle(m_cell, m_isGoalTile, residingEntity != nullptr);
+
+    if (m_isGoalTile)
+        setRestingState(m_residingEntity ? SpriteState::GoalFilled : SpriteState::Idle);
 }
 
 std::shared_ptr<Sprite> Tile::getResidingEntity() const
@@ -524,211 +627,353 @@ std::shared_ptr<Sprite> Tile::getResidingEntity() const
     return m_residingEntity;
 }
 
-GameBoard::GameBoard(const std::string& path, const std::shared_ptr<Player>& player, SDL_Renderer* cacheRenderer)
-    : m_cacheRenderer(cacheRenderer), m_player(player)
+GameBoard::GameBoard(const std::string& path, const std::shared_ptr<Player>& player, SDL_Renderer* cacheRenderer,
+    GameEventBus* eventBus)
+    : Observer(eventBus), m_cacheRenderer(cacheRenderer), m_player(player)
 {
     if (!m_player)
         throw std::runtime_error("Player must be initialized");
 
-    readDimensions(path);
-
-    // Determine offsets for matrices in the file
-    int offset = 1; // First line is dimensions
-    std::vector<std::vector<std::string>> tileKeys = loadMatrix(path, offset, m_boardRows, m_boardColumns);
-    offset += m_boardRows;
-    std::vector<std::vector<std::string>> immovableKeys = loadMatrix(path, offset, m_boardRows, m_boardColumns);
-    offset += m_boardRows;
-    std::vector<std::vector<std::string>> movableKeys = loadMatrix(path, offset, m_boardRows, m_boardColumns);
+    m_layers = loadLayers(path);
+    m_layoutHash = hashLayers(m_layers);
+    applyDimensions(m_layers.rows, m_layers.columns);
 
     // Lay tiles on the board
-    for (int i = 0; i < tileKeys.size(); ++i)
+    for (int i = 0; i < m_layers.rows; ++i)
+    {
+        for (int j = 0; j < m_layers.columns; ++j)
+            m_tiles.at(i, j) = createTile(m_layers.tiles[m_layers.index(i, j)], i, j);
+    }
+
+    // Place immovable and movable objects
+    for (int i = 0; i < m_layers.rows; ++i)
+    {
+        for (int j = 0; j < m_layers.columns; ++j)
+            placeObject(i, j);
+    }
+
+    rebuildSnapshot();
+    if (m_tiles.size() >= HIERARCHICAL_MIN_TILES)
+        m_pathfindingMethod = PathfindingMethod::Hierarchical;
+}
+
+std::vector<std::shared_ptr<Entity>> GameBoard::reload(const std::string& path)
+{
+    // Parsing checks every asset, so a bad level throws before the live board is touched
+    LevelLayers layers = loadLayers(path);
+
+    if (m_hoveredEntity)
+    {
+        m_hoveredEntity->onBlur();
+        m_hoveredEntity = nullptr;
+    }
+
+    // Sequences hold on to objects that may be replaced
+    m_actions.clear();
+    m_playerAction = 0;
+
+    const bool resized = layers.rows != m_layers.rows || layers.columns != m_layers.columns;
+
+    // A new object can't spawn under a block pushed onto its cell: that block would lose its tile
+    // and linger, drawn but unreachable. Rebuild the whole board instead, like a resize.
+    bool rebuildAll = resized;
+    for (int i = 0; i < layers.rows && !rebuildAll; ++i)
     {
-        std::vector<std::shared_ptr<Tile>> convertedRow;
-        for (int j = 0; j < tileKeys[i].size(); ++j) 
+        for (int j = 0; j < layers.columns && !rebuildAll; ++j)
         {
-            const std::string& textureKey = tileKeys[i][j];
-            try {
-                auto tile = Factory::create<Tile>(m_cacheRenderer, textureKey);
-                tile->setCoordinates(Vector2{ Tile::TILE_DIMENSIONS.x * i, Tile::TILE_DIMENSIONS.y * j });
-                convertedRow.push_back(tile);
-            }
-            catch (const std::out_of_range&) {
-                throw std::runtime_error("Invalid tile texture key: " + textureKey);
-            }
+            const size_t cell = layers.index(i, j);
+            const bool spawns = layers.immovables[cell] != EMPTY_ASSET || layers.movables[cell] != EMPTY_ASSET;
+            const bool changed = layers.immovables[cell] != m_layers.immovables[cell] || layers.movables[cell] != m_layers.movables[cell];
+            const std::shared_ptr<Sprite> resident = m_tiles.at(i, j)->getResidingEntity();
+            rebuildAll = spawns && changed && resident && resident != m_objects.at(i, j);
         }
-        m_tiles.push_back(convertedRow);
     }
 
-    // Place immovable objects
-    for (int i = 0; i < immovableKeys.size(); ++i) 
+    std::swap(m_layers, layers);
+    m_layoutHash = hashLayers(m_layers);
+    const LevelLayers& previous = layers;
+
+    std::vector<std::shared_ptr<Entity>> rebuilt;
+    if (rebuildAll)
     {
-        for (int j = 0; j < immovableKeys[i].size(); ++j) 
+        if (resized)
         {
-            const std::string& textureKey = immovableKeys[i][j];
-            if (textureKey != "Empty") 
+            applyDimensions(m_layers.rows, m_layers.columns);
+
+            // The size picks between the two defaults; a board set to A* keeps it
+            if (m_pathfindingMethod != PathfindingMethod::AStar)
+                m_pathfindingMethod = m_tiles.size() >= HIERARCHICAL_MIN_TILES ? PathfindingMethod::Hierarchical : PathfindingMethod::JumpPoint;
+        }
+
+        for (int i = 0; i < m_layers.rows; ++i)
+        {
+            for (int j = 0; j < m_layers.columns; ++j)
             {
-                try {
-                    auto gameObject = Factory::create<GameObject>(
-                        m_cacheRenderer, textureKey, GameObject::PhysicsType::Immovable
-                    );
-                    gameObject->setCoordinates(Vector2{ Tile::TILE_DIMENSIONS.x * i, Tile::TILE_DIMENSIONS.y * j });
-                }
-                catch (const std::out_of_range&) {
-                    throw std::runtime_error("Invalid immovable texture key: " + textureKey);
-                }
+                m_tiles.at(i, j) = createTile(m_layers.tiles[m_layers.index(i, j)], i, j);
+                rebuilt.push_back(m_tiles.at(i, j));
             }
         }
+
+        for (int i = 0; i < m_layers.rows; ++i)
+        {
+            for (int j = 0; j < m_layers.columns; ++j)
+            {
+                placeObject(i, j);
+                if (m_objects.at(i, j))
+                    rebuilt.push_back(m_objects.at(i, j));
+            }
+        }
+
+        rebuildSnapshot();
+        return rebuilt;
+    }
+
+    // Same size: only the changed cells are rebuilt, and everything derived from them patched like pushTile does
+    std::vector<int32_t> changed;
+    for (int i = 0; i < m_layers.rows; ++i)
+    {
+        for (int j = 0; j < m_layers.columns; ++j)
+        {
+            const size_t cell = m_layers.index(i, j);
+            if (m_layers.tiles[cell] == previous.tiles[cell])
+                continue;
+
+            // The resident moves over, so only the goal count needs fixing by hand
+            const std::shared_ptr<Tile> old = m_tiles.at(i, j);
+            const std::shared_ptr<Sprite> resident = old->getResidingEntity();
+            old->setResidingEntity(nullptr);
+            std::shared_ptr<Tile> tile = createTile(m_layers.tiles[cell], i, j);
+            m_occupancy.goalCount += static_cast<int>(tile->isGoalTile()) - static_cast<int>(old->isGoalTile());
+            tile->setResidingEntity(resident);
+            m_tiles.at(i, j) = tile;
+            markDirty(tile);
+            rebuilt.push_back(tile);
+            changed.push_back(getCellIndex({ i, j }));
+        }
     }
 
-    // Place movable objects
-    for (int i = 0; i < movableKeys.size(); ++i) 
+    for (int i = 0; i < m_layers.rows; ++i)
     {
-        for (int j = 0; j < movableKeys[i].size(); ++j) 
+        for (int j = 0; j < m_layers.columns; ++j)
         {
-            const std::string& textureKey = movableKeys[i][j];
-            if (textureKey != "Empty") 
+            const size_t cell = m_layers.index(i, j);
+            if (m_layers.immovables[cell] == previous.immovables[cell] && m_layers.movables[cell] == previous.movables[cell])
+                continue;
+
+            if (const int32_t freed = removeObject(i, j); freed >= 0)
             {
-                try {
-                    auto gameObject = Factory::create<GameObject>(
-                        m_cacheRenderer, textureKey, GameObject::PhysicsType::Movable, 1.0
-                    );
-                    gameObject->setCoordinates(Vector2{ Tile::TILE_DIMENSIONS.x * i, Tile::TILE_DIMENSIONS.y * j });
-                }
-                catch (const std::out_of_range&) {
-                    throw std::runtime_error("Invalid movable texture key: " + textureKey);
-                }
+                m_saveRecords.remove(freed);
+                changed.push_back(freed);
+            }
+            placeObject(i, j);
+            if (const std::shared_ptr<GameObject>& object = m_objects.at(i, j))
+            {
+                m_saveRecords.add(makeSaveRecord(*object, getCellIndex({ i, j })));
+                rebuilt.push_back(object);
+                changed.push_back(getCellIndex({ i, j }));
             }
         }
     }
+
+    patchCells(changed);
+    return rebuilt;
 }
 
-void GameBoard::readDimensions(const std::string& path)
+void GameBoard::patchCells(std::vector<int32_t>& cells)
 {
-    std::ifstream file(path);
-    if (!file.is_open())
-        throw std::runtime_error("Could not open file: " + path);
+    if (cells.empty())
+        return;
 
-    std::string line;
-    std::getline(file, line);
-    std::stringstream dimensionsStream(line);
-    dimensionsStream >> m_boardRows;
-    dimensionsStream.ignore(1);
-    dimensionsStream >> m_boardColumns;
+    std::sort(cells.begin(), cells.end());
+    cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+    if (cells.size() * PATCH_COST_IN_CELLS > m_tiles.size())
+    {
+        rebuildSnapshot();
+        return;
+    }
 
-    if (m_boardRows <= 0 || m_boardColumns <= 0 || m_boardRows > MAX_ROWS || m_boardColumns > MAX_COLUMNS)
-        throw std::runtime_error("Invalid board dimensions in file: " + path);
+    BoardSnapshot& snapshot = editSnapshot();
+    for (const int32_t cell : cells)
+    {
+        snapshot.cells[cell] = getCellFlags(*m_tiles.at(cell % m_tiles.columns(), cell / m_tiles.columns()));
+        const bool blocked = (snapshot.cells[cell] & (BoardSnapshot::WallFlag | BoardSnapshot::BlockFlag)) != 0;
+        m_jumpPoints.setBlocked(cell, blocked);
+        m_planner.setBlocked(cell, blocked);
+    }
+    m_sectors.setBlocked(snapshot, cells);
+}
 
-    m_boardBounds = 
+LevelLayers GameBoard::loadLayers(const std::string& path)
+{
+    if (EmbeddedLevels::isEmbedded(path))
     {
-        (m_boardRows) * Tile::TILE_DIMENSIONS.x - 5,
-        (m_boardColumns) * Tile::TILE_DIMENSIONS.y - 5
-    };
-    std::cout << m_boardBounds << "\n";
+        const EmbeddedLevels::Level* level = EmbeddedLevels::find(path);
+        if (!level)
+            throw std::runtime_error("No built-in level " + path);
+
+        // Their keys were checked at compile time, but collision comes from the manifest
+        LevelLayers layers = EmbeddedLevels::toLayers(*level);
+        checkLayers(layers);
+        return layers;
+    }
+    return loadLevelLayers(path, MAX_ROWS, MAX_COLUMNS);
 }
 
-std::vector<std::vector<std::string>> GameBoard::loadMatrix(const std::string& path, int offset, int expectedRows, int expectedColumns)
+uint64_t GameBoard::hashLayers(const LevelLayers& layers)
 {
-    std::ifstream file(path);
-    if (!file.is_open())
-        throw std::runtime_error("Could not open file: " + path);
+    // 64-bit FNV-1a over keys rather than ids, so reordering the manifest doesn't invalidate saves.
+    // Keys end with a zero byte so "ab", "c" and "a", "bc" differ
+    const AssetRegistry& registry = AssetRegistry::getInstance();
+    uint64_t value = 14695981039346656037ull;
+    const auto mix = [&value](const std::string& bytes)
+    {
+        for (const char byte : bytes)
+        {
+            value ^= static_cast<uint8_t>(byte);
+            value *= 1099511628211ull;
+        }
+        value *= 1099511628211ull;
+    };
 
-    // Skip lines up to the matrix start
-    std::string line;
-    for (int i = 0; i < offset; ++i) 
+    mix(std::to_string(layers.rows) + "x" + std::to_string(layers.columns));
+    for (const auto* layer : { &layers.tiles, &layers.immovables, &layers.movables })
     {
-        if (!std::getline(file, line))
-            throw std::runtime_error("Unexpected end of file before matrix data");
+        for (const AssetId id : *layer)
+            mix(registry.getKey(id));
     }
+    return value;
+}
 
-    // Read the matrix
-    std::vector<std::vector<std::string>> matrix;
-    for (int i = 0; i < expectedRows; ++i)
-    {
-        if (!std::getline(file, line))
-            throw std::runtime_error("Unexpected end of file in matrix data");
+void GameBoard::applyDimensions(const int rows, const int columns)
+{
+    m_boardRows = rows;
+    m_boardColumns = columns;
+    m_boardBounds = TileGeometry::toScreenCoordinates({ m_boardRows, m_boardColumns }) - Vector2{ 5, 5 };
+    m_tiles.resize(m_boardRows, m_boardColumns);
+    m_objects.resize(m_boardRows, m_boardColumns);
+}
 
-        if (line.empty()) continue;
+std::shared_ptr<Tile> GameBoard::createTile(const AssetId asset, const int x, const int y)
+{
+    try {
+        auto tile = Factory::create<Tile>(m_cacheRenderer, asset);
+        tile->setCoordinates(TileGeometry::toScreenCoordinates({ x, y }));
+        if (AssetRegistry::getInstance().isGoal(asset))
+            tile->setAsGoalTile();
+        tile->attachOccupancy(&m_occupancy, getCellIndex({ x, y }));
+        return tile;
+    }
+    catch (const std::out_of_range&) {
+        throw std::runtime_error("Invalid tile texture key: " + AssetRegistry::getInstance().getKey(asset));
+    }
+}
 
-        std::vector<std::string> rowElements;
-        std::stringstream ss(line);
-        std::string cell;
+std::shared_ptr<GameObject> GameBoard::createObject(const AssetId asset, const GameObject::PhysicsType type, const int x, const int y) const
+{
+    try {
+        auto gameObject = Factory::create<GameObject>(m_cacheRenderer, asset, type,
+            type == GameObject::PhysicsType::Movable ? 1.0 : 0.0, this);
+        gameObject->setCoordinates(TileGeometry::toScreenCoordinates({ x, y }));
+        return gameObject;
+    }
+    catch (const std::out_of_range&) {
+        throw std::runtime_error(std::string(type == GameObject::PhysicsType::Movable ? "Invalid movable" : "Invalid immovable")
+            + " texture key: " + AssetRegistry::getInstance().getKey(asset));
+    }
+}
 
-        while (std::getline(ss, cell, ','))
-            rowElements.push_back(cell);
+void GameBoard::placeObject(const int x, const int y)
+{
+    const size_t cell = m_layers.index(x, y);
+    std::shared_ptr<GameObject> object;
+    if (m_layers.immovables[cell] != EMPTY_ASSET)
+        object = createObject(m_layers.immovables[cell], GameObject::PhysicsType::Immovable, x, y);
 
-        if (static_cast<int>(rowElements.size()) != expectedColumns)
-            throw std::runtime_error("Row size mismatch in matrix data");
+    // The movable layer wins if both layers occupy the cell
+    if (m_layers.movables[cell] != EMPTY_ASSET)
+        object = createObject(m_layers.movables[cell], GameObject::PhysicsType::Movable, x, y);
 
-        matrix.push_back(rowElements);
+    m_objects.at(x, y) = object;
+    if (object)
+    {
+        m_tiles.at(x, y)->setResidingEntity(object);
+        markDirty(m_tiles.at(x, y));
     }
-
-    return matrix;
 }
 
-Vector2<int> GameBoard::snapScreenCoordinates(Vector2<int> coordinates)
+int32_t GameBoard::removeObject(const int x, const int y)
 {
-    int x = coordinates.x - (coordinates.x % Tile::TILE_DIMENSIONS.x);
-    int y = coordinates.y - (coordinates.y % Tile::TILE_DIMENSIONS.y);
-    return { x, y };
+    std::shared_ptr<GameObject> object = std::move(m_objects.at(x, y));
+    if (!object)
+        return -1;
+    std::erase(m_movingObjects, object);
+
+    // The object may have been pushed away from the cell it was spawned on
+    const int32_t cell = getRestingCell(*object);
+    const std::shared_ptr<Tile>& tile = m_tiles.at(cell % m_tiles.columns(), cell / m_tiles.columns());
+    if (tile->getResidingEntity() != object)
+        return -1;
+
+    tile->setResidingEntity(nullptr);
+    markDirty(tile);
+    return cell;
 }
 
-Vector2<int> GameBoard::centerScreenCoordinates(Vector2<int> coordinates, const SDL_Rect& spriteDimensions)
+void GameBoard::markDirty(const std::shared_ptr<Entity>& entity)
 {
-    int x = coordinates.x - (coordinates.x % Tile::TILE_DIMENSIONS.x) + (Tile::TILE_DIMENSIONS.x / 2) - (spriteDimensions.w / 2);
-    int y = coordinates.y - (coordinates.y % Tile::TILE_DIMENSIONS.y) + (Tile::TILE_DIMENSIONS.y / 2) - (spriteDimensions.h / 2);
-    return { x, y };
+    // Only tiles are composited; objects are drawn every frame anyway
+    const Vector2<int> cell = TileGeometry::toBoardCoordinates(entity->getWindowCoordinates());
+    if (m_tiles.contains(cell.x, cell.y) && m_tiles.at(cell.x, cell.y) == entity)
+        m_dirtyTiles.push_back(cell);
 }
 
-Vector2<int> GameBoard::getGameBoardCoordinates(Vector2<int> coordinates) const
+std::vector<std::shared_ptr<GameObject>> GameBoard::getObjects() const
 {
-    return { coordinates.x / Tile::TILE_DIMENSIONS.x, coordinates.y / Tile::TILE_DIMENSIONS.y };
+    std::vector<std::shared_ptr<GameObject>> objects;
+    for (const auto& object : m_objects)
+    {
+        if (object)
+            objects.push_back(object);
+    }
+    return objects;
 }
 
 std::shared_ptr<Tile> GameBoard::getEnclosingTile(const Vector2<int>& position) const
 {
-    Vector2<int> tileCoordinates = snapScreenCoordinates(position);
-    int xIndex = tileCoordinates.x / Tile::TILE_DIMENSIONS.x;
-    int yIndex = tileCoordinates.y / Tile::TILE_DIMENSIONS.y;
-    if (xIndex >= m_boardColumns || yIndex >= m_boardRows)
-        return nullptr;
-    return m_tiles[xIndex][yIndex];
+    const Vector2<int> index = TileGeometry::toBoardCoordinates(position);
+    return getTile(index.x, index.y);
 }
 
 std::shared_ptr<Tile> GameBoard::getTile(int x, int y) const
 {
-    if (x >= m_boardColumns || y >= m_boardRows || x < 0 || y < 0)
+    if (!m_tiles.contains(x, y))
         return nullptr;
-    return m_tiles[x][y];
+    return m_tiles.at(x, y);
 }
 
 std::vector<std::shared_ptr<Tile>> GameBoard::getTiles() const
 {
-    size_t total_size = 0;
-    for (const auto& v : m_tiles)
-        total_size += v.size();
-
-    std::vector<std::shared_ptr<Tile>> tiles;
-    tiles.reserve(total_size);
-
-    for (const auto& v : m_tiles)
-        tiles.insert(tiles.end(), v.begin(), v.end());
-
-    return tiles;
+    return { m_tiles.begin(), m_tiles.end() };
 }
 
-void GameBoard::pushTile(const std::shared_ptr<Sprite>&entity, const Vector2<int>&playerPosition) const
+bool GameBoard::pushTile(const std::shared_ptr<Sprite>&entity, const Vector2<int>&playerPosition)
 {
+    // Walls share the tiles with blocks, but only blocks move
+    const auto object = std::dynamic_pointer_cast<GameObject>(entity);
+    if (object && object->getPhysicsType() == GameObject::PhysicsType::Immovable)
+        return false;
+
     std::shared_ptr<Tile> playerTile = getEnclosingTile(playerPosition);
     std::shared_ptr<Tile> entityTile = getEnclosingTile(entity->getWindowCoordinates());
 
     if (!playerTile || !entityTile)
-        return;
+        return false;
 
     int dX = playerTile->getWindowCoordinates().x - entityTile->getWindowCoordinates().x;
     int dY = playerTile->getWindowCoordinates().y - entityTile->getWindowCoordinates().y;
 
     if (std::abs(dX) > Tile::TILE_DIMENSIONS.x || std::abs(dY) > Tile::TILE_DIMENSIONS.y)
-        return;
+        return false;
 
     int dirX = 0, dirY = 0;
     if (std::abs(dX) > std::abs(dY))
@@ -736,8 +981,9 @@ void GameBoard::pushTile(const std::shared_ptr<Sprite>&entity, const Vector2<int
     else
         dirY = (dY > 0) ? -1 : 1;
 
-    int currentX = entityTile->getWindowCoordinates().x / Tile::TILE_DIMENSIONS.x;
-    int currentY = entityTile->getWindowCoordinates().y / Tile::TILE_DIMENSIONS.y;
+    const Vector2<int> entityIndex = TileGeometry::toBoardCoordinates(entityTile->getWindowCoordinates());
+    int currentX = entityIndex.x;
+    int currentY = entityIndex.y;
 
     std::shared_ptr<Tile> targetTile = nullptr;
     while (true)
@@ -745,10 +991,10 @@ void GameBoard::pushTile(const std::shared_ptr<Sprite>&entity, const Vector2<int
         int nextX = currentX + dirX;
         int nextY = currentY + dirY;
 
-        if (nextX < 0 || nextX >= m_boardColumns || nextY < 0 || nextY >= m_boardRows)
+        if (!m_tiles.contains(nextX, nextY))
             break;
 
-        std::shared_ptr<Tile> nextTile = m_tiles[nextX][nextY];
+        std::shared_ptr<Tile> nextTile = m_tiles.at(nextX, nextY);
         if (nextTile->getResidingEntity() != nullptr)
             break;
 
@@ -757,13 +1003,42 @@ void GameBoard::pushTile(const std::shared_ptr<Sprite>&entity, const Vector2<int
         currentY = nextY;
     }
 
-    if (targetTile)
+    if (!targetTile)
+        return false;
+
+    // Copying the snapshot and save pages a worker still holds, and the new slide, allocate by design
+    AllocationTracker::ExpectedScope expected;
+    entityTile->setResidingEntity(nullptr);
+    targetTile->setResidingEntity(entity);
+    markDirty(entityTile);
+    markDirty(targetTile);
+
+    BoardSnapshot& snapshot = editSnapshot();
+    snapshot.cells[getCellIndex(entityIndex)] &= ~BoardSnapshot::BlockFlag;
+    snapshot.cells[getCellIndex({ currentX, currentY })] |= BoardSnapshot::BlockFlag;
+    m_jumpPoints.setBlocked(getCellIndex(entityIndex), false);
+    m_jumpPoints.setBlocked(getCellIndex({ currentX, currentY }), true);
+    m_sectors.setBlocked(getCellIndex(entityIndex), false);
+    m_sectors.setBlocked(getCellIndex({ currentX, currentY }), true);
+    m_planner.setBlocked(getCellIndex(entityIndex), false);
+    m_planner.setBlocked(getCellIndex({ currentX, currentY }), true);
+
+    publish(TilePushed{ getCellIndex(entityIndex), getCellIndex({ currentX, currentY }) });
+    if (targetTile->isGoalTile())
+        publish(BlockReachedGoal{ getCellIndex({ currentX, currentY }) });
+    Vector2 destination = centerScreenCoordinates(targetTile->getWindowCoordinates(), entity->getSdlRect());
+    entity->setState(SpriteState::Pushed);
+    if (object)
     {
-        entityTile->setResidingEntity(nullptr);
-        targetTile->setResidingEntity(entity);
-        Vector2 destination = centerScreenCoordinates(targetTile->getWindowCoordinates(), entity->getSdlRect());
-        entity->walk({ destination });
+        object->walkTo(destination);
+        if (std::find(m_movingObjects.begin(), m_movingObjects.end(), object) == m_movingObjects.end())
+            m_movingObjects.push_back(object);
     }
+    else
+        entity->walk({ destination });
+    m_saveRecords.push(getCellIndex(entityIndex), getCellIndex({ currentX, currentY }), destination.x, destination.y,
+        static_cast<uint8_t>(SpriteState::Pushed));
+    return true;
 }
 
 std::shared_ptr<Tile> GameBoard::getClosestAvailableTile(const Vector2<int>&tilePosition, const Vector2<int>&playerCoordinates) const
@@ -776,9 +1051,9 @@ std::shared_ptr<Tile> GameBoard::getClosestAvailableTile(const Vector2<int>&tile
         { 0, 1 }
     };
 
-    Vector2<int> coordinates = snapScreenCoordinates(tilePosition);
-    int tileX = coordinates.x / Tile::TILE_DIMENSIONS.x;
-    int tileY = coordinates.y / Tile::TILE_DIMENSIONS.y;
+    const Vector2<int> index = TileGeometry::toBoardCoordinates(tilePosition);
+    int tileX = index.x;
+    int tileY = index.y;
 
     std::shared_ptr<Tile> closestTile = nullptr;
     double minDistance = std::numeric_limits<double>::max();
@@ -788,14 +1063,15 @@ std::shared_ptr<Tile> GameBoard::getClosestAvailableTile(const Vector2<int>&tile
         int newX = tileX + dir.x;
         int newY = tileY + dir.y;
 
-        if (newX >= 0 && newX < m_boardColumns && newY >= 0 && newY < m_boardRows)
+        if (m_tiles.contains(newX, newY))
         {
-            std::shared_ptr<Tile> adjacentTile = m_tiles[newX][newY];
+            std::shared_ptr<Tile> adjacentTile = m_tiles.at(newX, newY);
 
             if (adjacentTile->getResidingEntity() == nullptr)
             {
-                double distance = std::sqrt(std::pow(newX * Tile::TILE_DIMENSIONS.x - playerCoordinates.x, 2) +
-                    std::pow(newY * Tile::TILE_DIMENSIONS.y - playerCoordinates.y, 2));
+                const Vector2<int> adjacentCoordinates = TileGeometry::toScreenCoordinates({ newX, newY });
+                double distance = std::sqrt(std::pow(adjacentCoordinates.x - playerCoordinates.x, 2) +
+                    std::pow(adjacentCoordinates.y - playerCoordinates.y, 2));
 
                 if (distance < minDistance)
                 {
@@ -852,9 +1128,136 @@ std::vector<std::shared_ptr<Tile>> GameBoard::getNeighborTiles(const std::shared
 
 std::vector<std::shared_ptr<Tile>> GameBoard::getPathToTile(const std::shared_ptr<Tile>& startTile, const std::shared_ptr<Tile>& goalTile) const
 {
+    return getPathToTile(startTile, goalTile, m_pathfindingMethod);
+}
+
+std::vector<std::shared_ptr<Tile>> GameBoard::getPathToTile(const std::shared_ptr<Tile>& startTile, const std::shared_ptr<Tile>& goalTile,
+    const PathfindingMethod method) const
+{
+    AllocationTracker::Scope scope(AllocationCategory::Pathfinding);
+    QueryTimer timer(m_lastPathQueryTime);
     if (!startTile || !goalTile)
         return {};
 
+    const int32_t start = getCellIndex(getGameBoardCoordinates(startTile->getWindowCoordinates()));
+    const int32_t goal = getCellIndex(getGameBoardCoordinates(goalTile->getWindowCoordinates()));
+    switch (method)
+    {
+    case PathfindingMethod::JumpPoint:
+        return getTilesAt(m_jumpPoints.findPath(start, goal));
+    case PathfindingMethod::Hierarchical:
+        return getTilesAt(m_sectors.findPath(start, goal));
+    case PathfindingMethod::AStar:
+    default:
+        return findPathAStar(startTile, goalTile);
+    }
+}
+
+std::vector<std::shared_ptr<Tile>> GameBoard::getTilesAt(const std::vector<int32_t>& cells) const
+{
+    std::vector<std::shared_ptr<Tile>> tiles;
+    tiles.reserve(cells.size());
+    for (const int32_t cell : cells)
+        tiles.push_back(getTile(cell % m_tiles.columns(), cell / m_tiles.columns()));
+    return tiles;
+}
+
+std::vector<Vector2<int>> GameBoard::getCheckpoints(const std::vector<int32_t>& cells, const Sprite& walker) const
+{
+    std::vector<Vector2<int>> checkpoints;
+    checkpoints.reserve(cells.size());
+    for (const int32_t cell : cells)
+        checkpoints.push_back(getCellCenter(cell, walker));
+    return checkpoints;
+}
+
+Vector2<int> GameBoard::getCellCenter(const int32_t cell, const Sprite& walker) const
+{
+    const Vector2<int> tile = TileGeometry::toScreenCoordinates({ cell % m_tiles.columns(), cell / m_tiles.columns() });
+    return centerScreenCoordinates(tile, walker.getSdlRect());
+}
+
+CooperativePlanner::AgentId GameBoard::addMover(const std::shared_ptr<GameObject>& object, const Vector2<int>& cell, const Vector2<int>& goal)
+{
+    const CooperativePlanner::AgentId mover = m_planner.addAgent(getCellIndex(cell), getCellIndex(goal));
+    if (m_movers.size() <= static_cast<size_t>(mover))
+        m_movers.resize(mover + 1);
+    m_movers[mover] = object;
+
+    // Fast enough to cross any tile within a step
+    object->setSpeed(std::max(Tile::TILE_DIMENSIONS.x, Tile::TILE_DIMENSIONS.y) / MOVER_STEP_TIME);
+    object->setCoordinates(centerScreenCoordinates(TileGeometry::toScreenCoordinates(cell), object->getSdlRect()));
+    return mover;
+}
+
+bool GameBoard::startPlayerRoute(const std::shared_ptr<Tile>& goalTile)
+{
+    AllocationTracker::Scope scope(AllocationCategory::Pathfinding);
+    QueryTimer timer(m_lastPathQueryTime);
+    const std::shared_ptr<Tile> startTile = getEnclosingTile(m_player->getWindowCoordinates());
+    if (!startTile)
+        return false;
+
+    m_playerRoute = m_sectors.findRoute(getCellIndex(getGameBoardCoordinates(startTile->getWindowCoordinates())),
+        getCellIndex(getGameBoardCoordinates(goalTile->getWindowCoordinates())));
+    if (m_playerRoute.empty())
+    {
+        m_player->walk({});
+        return false;
+    }
+
+    // Only the first sector is walked out now; update() refines the rest as the player gets there
+    m_player->walk(getCheckpoints(m_playerRoute.isFinished() ? m_playerRoute.waypoints : m_sectors.refineNext(m_playerRoute), *m_player));
+    editSnapshot().playerCell = m_playerRoute.getGoal();
+    return true;
+}
+
+ActionTask GameBoard::walkAndPush(const std::shared_ptr<Sprite> block, const std::shared_ptr<Tile> standTile)
+{
+    std::vector<std::shared_ptr<Tile>> tiles = getPathToTile(getEnclosingTile(m_player->getWindowCoordinates()), standTile);
+    if (tiles.empty())
+        co_return;
+
+    std::vector<Vector2<int>> path;
+    path.reserve(tiles.size());
+    for (const auto& i : tiles)
+        path.push_back(centerScreenCoordinates(i->getWindowCoordinates(), m_player->getSdlRect()));
+    m_player->walk(path);
+    editSnapshot().playerCell = getCellIndex(getGameBoardCoordinates(standTile->getWindowCoordinates()));
+    co_await waitForWalk(m_player);
+
+    // pushTile ignores the block if it was pushed out of reach meanwhile
+    if (!pushTile(block, m_player->getWindowCoordinates()))
+        co_return;
+    if (const auto object = std::dynamic_pointer_cast<GameObject>(block))
+        co_await waitForWalk(object);
+}
+
+void GameBoard::continuePlayerRoute()
+{
+    // Refinement searches the next sector, which allocates by design even on a frame without input
+    AllocationTracker::Scope scope(AllocationCategory::Pathfinding);
+    AllocationTracker::ExpectedScope expected;
+    QueryTimer timer(m_lastPathQueryTime);
+    std::vector<int32_t> cells = m_sectors.refineNext(m_playerRoute);
+    if (cells.empty())
+    {
+        // A push blocked the segment after it was planned; plan again from where it starts
+        const int32_t from = m_playerRoute.waypoints[m_playerRoute.nextSegment];
+        m_playerRoute = m_sectors.findRoute(from, m_playerRoute.getGoal());
+        if (m_playerRoute.isFinished())
+        {
+            m_playerRoute = {};
+            editSnapshot().playerCell = from;
+            return;
+        }
+        cells = m_sectors.refineNext(m_playerRoute);
+    }
+    m_player->extendWalk(getCheckpoints(cells, *m_player));
+}
+
+std::vector<std::shared_ptr<Tile>> GameBoard::findPathAStar(const std::shared_ptr<Tile>& startTile, const std::shared_ptr<Tile>& goalTile) const
+{
     auto compare = [](const std::shared_ptr<AStarNode>& a, const std::shared_ptr<AStarNode>& b) -> bool
     {
         return *a > *b;
@@ -919,18 +1322,239 @@ std::vector<std::shared_ptr<Tile>> GameBoard::getPathToTile(const std::shared_pt
     return {};
 }
 
-bool GameBoard::isSolved()
+SaveState GameBoard::captureSaveState(const std::string& levelPath)
+{
+    SaveState state;
+    state.levelPath = levelPath;
+    state.layoutHash = m_layoutHash;
+    state.occupancyHash = m_occupancy.hash;
+    state.board = m_snapshot;
+    state.playerX = m_player->getWindowCoordinates().x;
+    state.playerY = m_player->getWindowCoordinates().y;
+    const std::span<const Vector2<int>> checkpoints = m_player->getPendingCheckpoints();
+    state.playerCheckpoints.reserve(checkpoints.size());
+    for (const Vector2<int>& checkpoint : checkpoints)
+        state.playerCheckpoints.push_back({ checkpoint.x, checkpoint.y });
+    state.routeWaypoints = m_playerRoute.waypoints;
+    state.routeNextSegment = static_cast<uint32_t>(m_playerRoute.nextSegment);
+    state.objects = m_saveRecords.share([this](SaveObject& record)
+    {
+        const GameObject& object = *m_objects.at(record.spawnCell % m_tiles.columns(), record.spawnCell / m_tiles.columns());
+        record.x = object.getWindowCoordinates().x;
+        record.y = object.getWindowCoordinates().y;
+        record.state = static_cast<uint8_t>(object.getState());
+        record.restingState = static_cast<uint8_t>(object.getRestingState());
+        return object.getRemainingCheckpoints() > 0;
+    });
+    state.objectCount = m_saveRecords.size();
+    return state;
+}
+
+void GameBoard::rebuildSaveRecords()
 {
-    for (const auto& column : m_tiles)
+    m_saveRecords.reset(m_tiles.size());
+    for (int y = 0; y < m_objects.rows(); ++y)
     {
-        for (const auto& tile : column)
+        for (int x = 0; x < m_objects.columns(); ++x)
         {
-            if (!tile->isGoalTile())
-                continue;
+            if (const std::shared_ptr<GameObject>& object = m_objects.at(x, y))
+                m_saveRecords.add(makeSaveRecord(*object, getCellIndex({ x, y })));
+        }
+    }
+}
+
+SaveObject GameBoard::makeSaveRecord(const GameObject& object, const int32_t spawnCell) const
+{
+    SaveObject record{};
+    record.x = object.getWindowCoordinates().x;
+    record.y = object.getWindowCoordinates().y;
+    record.spawnCell = spawnCell;
+    record.cell = getRestingCell(object);
+    const std::span<const Vector2<int>> checkpoints = object.getPendingCheckpoints();
+    if (!checkpoints.empty())
+    {
+        record.hasCheckpoint = 1;
+        record.checkpointX = checkpoints.back().x;
+        record.checkpointY = checkpoints.back().y;
+    }
+    record.state = static_cast<uint8_t>(object.getState());
+    record.restingState = static_cast<uint8_t>(object.getRestingState());
+    return record;
+}
+
+int32_t GameBoard::getRestingCell(const GameObject& object) const
+{
+    // A pushed object already resides on the tile it is sliding to
+    const std::span<const Vector2<int>> checkpoints = object.getPendingCheckpoints();
+    if (!checkpoints.empty())
+        return getCellIndex(getGameBoardCoordinates(checkpoints.back()));
+    return getCellIndex(getGameBoardCoordinates(object.getWindowCoordinates()));
+}
+
+void GameBoard::restore(const SaveFile& save)
+{
+    const SaveHeader& header = save.getHeader();
+    if (header.columns != m_tiles.columns() || header.rows != m_tiles.rows() || header.layoutHash != m_layoutHash)
+        throw std::runtime_error("Save was taken on a different layout of this level");
+
+    // Every object of the level exactly once, on distinct cells, matching the recorded hash
+    const SaveObject* records = save.getObjects();
+    const int32_t cellCount = static_cast<int32_t>(m_tiles.size());
+    std::vector<uint8_t> spawned(m_tiles.size());
+    std::vector<uint8_t> occupied(m_tiles.size());
+    uint64_t occupancyHash = 0;
+    size_t objectCount = 0;
+    for (const auto& object : m_objects)
+        objectCount += object != nullptr;
+    if (header.objectCount != objectCount)
+        throw std::runtime_error("Save has " + std::to_string(header.objectCount) + " objects, the level " + std::to_string(objectCount));
+    for (uint32_t i = 0; i < header.objectCount; ++i)
+    {
+        const SaveObject& record = records[i];
+        if (record.spawnCell < 0 || record.spawnCell >= cellCount || record.cell < 0 || record.cell >= cellCount ||
+            record.state >= SPRITE_STATE_COUNT || record.restingState >= SPRITE_STATE_COUNT ||
+            !m_objects.at(record.spawnCell % m_tiles.columns(), record.spawnCell / m_tiles.columns()) ||
+            spawned[record.spawnCell]++ || occupied[record.cell]++)
+            throw std::runtime_error("Save object " + std::to_string(i) + " is invalid");
+        occupancyHash ^= BoardOccupancy::key(record.cell);
+    }
+    if (occupancyHash != header.occupancyHash)
+        throw std::runtime_error("Save objects don't match its occupancy hash");
+    if (header.playerCell < 0 || header.playerCell >= cellCount)
+        throw std::runtime_error("Save player cell is invalid");
+    for (uint32_t i = 0; i < header.routeWaypointCount; ++i)
+    {
+        if (save.getRouteWaypoints()[i] < 0 || save.getRouteWaypoints()[i] >= cellCount)
+            throw std::runtime_error("Save route is invalid");
+    }
 
-            if (tile->getResidingEntity() == nullptr)
-                return false;
+    if (m_hoveredEntity)
+    {
+        m_hoveredEntity->onBlur();
+        m_hoveredEntity = nullptr;
+    }
+    m_actions.clear();
+    m_playerAction = 0;
+    for (const auto& tile : m_tiles)
+    {
+        if (tile->getResidingEntity())
+        {
+            tile->setResidingEntity(nullptr);
+            markDirty(tile);
         }
     }
-    return true;
-}
\ No newline at end of file
+
+    for (uint32_t i = 0; i < header.objectCount; ++i)
+    {
+        const SaveObject& record = records[i];
+        const std::shared_ptr<GameObject>& object = m_objects.at(record.spawnCell % m_tiles.columns(), record.spawnCell / m_tiles.columns());
+        object->setCoordinates({ record.x, record.y });
+        object->walk(record.hasCheckpoint ? std::vector{ Vector2{ record.checkpointX, record.checkpointY } } : std::vector<Vector2<int>>{});
+        object->setRestingState(static_cast<SpriteState>(record.restingState));
+        object->setState(static_cast<SpriteState>(record.state));
+
+        const std::shared_ptr<Tile>& tile = m_tiles.at(record.cell % m_tiles.columns(), record.cell / m_tiles.columns());
+        tile->setResidingEntity(object);
+        markDirty(tile);
+    }
+
+    std::vector<Vector2<int>> checkpoints;
+    checkpoints.reserve(header.playerCheckpointCount);
+    for (uint32_t i = 0; i < header.playerCheckpointCount; ++i)
+        checkpoints.emplace_back(save.getPlayerCheckpoints()[i].x, save.getPlayerCheckpoints()[i].y);
+    m_player->setCoordinates({ header.playerX, header.playerY });
+    m_player->walk(checkpoints);
+
+    rebuildSnapshot();
+    editSnapshot().playerCell = header.playerCell;
+    m_playerRoute.waypoints.assign(save.getRouteWaypoints(), save.getRouteWaypoints() + header.routeWaypointCount);
+    m_playerRoute.nextSegment = header.routeNextSegment;
+}
+
+void GameBoard::rebuildSnapshot()
+{
+    clearHint();
+    auto snapshot = std::make_shared<BoardSnapshot>();
+    snapshot->columns = m_tiles.columns();
+    snapshot->rows = m_tiles.rows();
+    snapshot->cells.resize(m_tiles.size());
+    snapshot->version = m_snapshot ? m_snapshot->version + 1 : 0;
+
+    // Recounted in the same pass; rebuilt cells were attached before their neighbours were final
+    m_occupancy = {};
+
+    for (int y = 0; y < m_tiles.rows(); ++y)
+    {
+        for (int x = 0; x < m_tiles.columns(); ++x)
+        {
+            const std::shared_ptr<Tile>& tile = m_tiles.at(x, y);
+            m_occupancy.goalCount += tile->isGoalTile();
+            if (tile->getResidingEntity())
+                m_occupancy.toggle(getCellIndex({ x, y }), tile->isGoalTile(), true);
+            snapshot->cells[getCellIndex({ x, y })] = getCellFlags(*tile);
+        }
+    }
+
+    const Vector2<int> player = getGameBoardCoordinates(m_player->getWindowCoordinates());
+    snapshot->playerCell = m_tiles.contains(player.x, player.y) ? getCellIndex(player) : 0;
+    m_jumpPoints.rebuild(*snapshot);
+    m_sectors.rebuild(*snapshot);
+    m_planner.rebuild(*snapshot);
+    if (m_planner.getAgentCount() != m_movers.size())
+        m_movers.clear();   // Resized; the planner dropped its agents
+    m_playerRoute = {};
+    m_snapshot = std::move(snapshot);
+    rebuildSaveRecords();
+
+    m_movingObjects.clear();
+    for (const auto& object : m_objects)
+    {
+        if (object && object->isMoving())
+            m_movingObjects.push_back(object);
+    }
+}
+
+uint8_t GameBoard::getCellFlags(const Tile& tile)
+{
+    uint8_t flags = tile.isGoalTile() ? BoardSnapshot::GoalFlag : 0;
+    if (const auto object = std::dynamic_pointer_cast<GameObject>(tile.getResidingEntity()))
+    {
+        flags |= object->getPhysicsType() == GameObject::PhysicsType::Immovable
+            ? BoardSnapshot::WallFlag
+            : BoardSnapshot::BlockFlag;
+    }
+    return flags;
+}
+
+BoardSnapshot& GameBoard::editSnapshot()
+{
+    // Copy on write: a worker may still be reading the shared instance
+    if (m_snapshot.use_count() > 1)
+        m_snapshot = std::make_shared<BoardSnapshot>(*m_snapshot);
+    ++m_snapshot->version;
+    clearHint();
+    return *m_snapshot;
+}
+
+void GameBoard::showHint(const Hint& hint)
+{
+    if (hint.version != m_snapshot->version || hint.blockCell < 0)
+        return;
+
+    clearHint();
+    const std::shared_ptr<Tile> tile = getTile(hint.blockCell % m_tiles.columns(), hint.blockCell / m_tiles.columns());
+    if (!tile || !tile->getResidingEntity())
+        return;
+
+    m_hintedEntity = tile->getResidingEntity();
+    m_hintedEntity->setRestingState(SpriteState::Selected);
+}
+
+void GameBoard::clearHint()
+{
+    if (m_hintedEntity)
+    {
+        m_hintedEntity->setRestingState(SpriteState::Idle);
+        m_hintedEntity = nullptr;
+    }
+}
@@ -13,45 +13,30 @@
 #include <algorithm>
 #include <limits>
 #include <queue>
+#include <span>
+#include <utility>
 #include <unordered_set>
 #include <sstream>
 #include <fstream>
 #include <vector>
 
 #include "GameState.h"
+#include "SpriteModifier.h"
+#include "SpriteState.h"
+#include "TextureResidency.h"
+#include "BoardGeometry.h"
+#include "TileGrid.h"
+#include "LevelData.h"
+#include "BoardSnapshot.h"
+#include "HintSolver.h"
+#include "JumpPointSearch.h"
+#include "SectorGraph.h"
+#include "CooperativePlanner.h"
+#include "SaveGame.h"
+#include "ActionScheduler.h"
 
 
 class Player;
-/**
- * @brief Struct to perform offset operations on SDL_Colors
- */
-struct SpriteModifier
-{
-    SpriteModifier(const std::string& description, const int r, const int g, const int b, const int a)
-        : name(description), r(r), g(g), b(b), a(a) {}
-
-    SpriteModifier() = default;
-
-    SpriteModifier(const std::string& description, const SDL_Color& other)
-        : name(description), r(other.r), g(other.g), b(other.b), a(other.a) {}
-
-    static constexpr uint8_t colorClamp(const int value)
-    {
-        return static_cast<uint8_t>(value > 255 ? 255 : (value < 0 ? 0 : value));
-    }
-
-    // Returns a properly clamped SDL_Color.
-    SDL_Color toSdlColor() const;
-    std::string name;
-    int r, g, b, a;
-};
-
-inline std::ostream& operator<<(std::ostream& os, const SpriteModifier& color)
-{
-    os << "{" << color.r << ", " << color.g << ", " << color.b << ", " << color.a << "}";
-    return os;
-}
-
 //TODO: Put inside somewhere
 enum class CollisionDetectionMethod
 {
@@ -60,6 +45,13 @@ enum class CollisionDetectionMethod
     PolygonCollision
 };
 
+enum class PathfindingMethod
+{
+    AStar = 0,
+    JumpPoint,     // Same path lengths as AStar, far fewer expansions on open boards
+    Hierarchical   // Near-optimal; click-to-walk refines one sector at a time as it is walked
+};
+
 class Entity
 {
 public:
@@ -80,9 +72,12 @@ public:
     virtual void cacheTexture() {}
     [[nodiscard]] virtual Vector2<double> getWindowCoordinates() const { return {}; }
     [[nodiscard]] virtual SDL_Rect getSdlRect() const { return SDL_Rect{}; }
+    [[nodiscard]] virtual SDL_Rect getRenderRect(double interpolation) const { return getSdlRect(); }
     [[nodiscard]] virtual SDL_Texture* getCachedTexture() const { return nullptr; }
+    [[nodiscard]] virtual const SDL_Rect* getSourceRect() const { return nullptr; }  // Part of getCachedTexture() to draw, nullptr for all of it
     [[nodiscard]] virtual std::vector<SDL_Rect> slice(int sliceThickness) const { return {}; }
     [[nodiscard]] virtual bool getRenderFlag() const { return true; }
+    [[nodiscard]] virtual bool isMoving() const { return false; }
     [[nodiscard]] virtual const Observer* getCollisionObserver() const { return nullptr; }
 
     /**
@@ -115,6 +110,14 @@ public:
     void resetSurface() override;
     void printSlices();
 
+    // States, switched without touching pixels when the sprite has baked state textures
+    void setState(const SpriteState state) { m_state = state; }
+    void setRestingState(SpriteState state);
+    void restoreRestingState() { m_state = m_restingState; }
+    [[nodiscard]] SpriteState getState() const { return m_state; }
+    [[nodiscard]] SpriteState getRestingState() const { return m_restingState; }
+    [[nodiscard]] bool hasStateTextures() const { return m_stateTextures != nullptr; }
+
     // Modifiers
     void pushModifier(const SpriteModifier& modifier);
     void removeModifier(const std::string& name);
@@ -131,6 +134,7 @@ public:
     [[nodiscard]] Vector2<double> getWindowCoordinates() const override { return m_coordinates; }
     [[nodiscard]] SDL_Surface* getSdlSurface() const;
     [[nodiscard]] SDL_Texture* getCachedTexture() const override;
+    [[nodiscard]] const SDL_Rect* getSourceRect() const override;
     [[nodiscard]] std::vector<SDL_Rect> slice(int sliceThickness) const override;
     [[nodiscard]] const Observer* getCollisionObserver() const override { return m_observer; }
     //[[nodiscard]] std::vector<std::shared_ptr<Sprite>> processSlices() const;
@@ -147,23 +151,54 @@ public:
 
 protected:
     static SDL_Surface* loadSurface(const char* path);
+    void releaseCachedTextures(size_t fromDepth);
     bool m_renderFlag{}; // Controls the visibility of the sprite
     SDL_Rect m_rect{};
     Vector2<double> m_coordinates{};
     const SDL_Surface* m_surfaceOriginal;
     SDL_Surface* m_surface{};
-    SDL_Texture* m_texture{};
     const Observer* m_observer;
     std::vector<SDL_Rect> m_slices{};
     std::vector<SpriteModifier> m_modifierStack;  // Collection of active modifiers
-    std::vector<SDL_Texture*> m_cachedTextures;   // Cache for textures at each stage
+    std::vector<TextureResidency::Handle> m_cachedTextures; // Cached variant at each modifier depth
     SDL_Renderer* m_cacheRenderer;
+    std::shared_ptr<const StateTextures> m_stateTextures; // Shared with every sprite of the same asset
+    SpriteState m_state = SpriteState::Idle;
+    SpriteState m_restingState = SpriteState::Idle;       // State to fall back to after hover or movement
+};
+
+/**
+ * @brief Filled-goal count and 64-bit Zobrist hash of the cells holding an object.
+ * Kept current by Tile::setResidingEntity; keys depend only on the cell index, so hashes are
+ * stable across runs and can be compared against recorded replays.
+ */
+struct BoardOccupancy
+{
+    int goalCount{};
+    int filledGoals{};
+    uint64_t hash{};
+
+    [[nodiscard]] static constexpr uint64_t key(const int32_t cell)
+    {
+        // splitmix64 of the cell index
+        uint64_t value = static_cast<uint64_t>(cell) + 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    void toggle(const int32_t cell, const bool isGoal, const bool occupied)
+    {
+        hash ^= key(cell);
+        if (isGoal)
+            filledGoals += occupied ? 1 : -1;
+    }
 };
 
 class Tile : public Sprite
 {
 public:
-    static constexpr Vector2<int> TILE_DIMENSIONS = { 86, 64 };
+    static constexpr Vector2<int> TILE_DIMENSIONS = TileGeometry::TILE_DIMENSIONS;
 
     Tile(const std::string& texturePath, SDL_Renderer* cacheRenderer,
         const std::shared_ptr<Sprite>& residingEntity = nullptr,
@@ -171,6 +206,11 @@ public:
     );
 
     void setAsGoalTile() { m_isGoalTile = true; }
+
+    /**
+     * @brief Reports occupancy changes of this tile to the board's counters from now on.
+     */
+    void attachOccupancy(BoardOccupancy* occupancy, const int32_t cell) { m_occupancy = occupancy; m_cell = cell; }
     void setResidingEntity(const std::shared_ptr<Sprite>& residingEntity);
     [[nodiscard]] bool isGoalTile() const { return m_isGoalTile; }
     [[nodiscard]] std::shared_ptr<Sprite> getResidingEntity() const;
@@ -178,8 +218,12 @@ public:
 private:
     std::shared_ptr<Sprite> m_residingEntity;
     bool m_isGoalTile;
+    BoardOccupancy* m_occupancy{};
+    int32_t m_cell{};
 };
 
+using DynamicBoard = TileGrid<std::shared_ptr<Tile>>;
+
 class GameObject : public Sprite
 {
 public:
@@ -209,13 +253,43 @@ public:
           m_speed(type == PhysicsType::Immovable ? 0 : speed),
           m_physicsType(type) {}
 
+    /**
+     * @brief Advances along the path by exactly m_speed * deltaTime, carrying leftover distance
+     * across checkpoints. Meant to be called with a fixed timestep.
+     */
     void update(const GameState& state) override;
-    void walk(const std::vector<Vector2<int>>& path) override { m_checkpoints = path; }
+    void walk(const std::vector<Vector2<int>>& path) override { m_checkpoints = path; m_nextCheckpoint = 0; }
+
+    /**
+     * @brief Walks to a single checkpoint, reusing the checkpoint storage of earlier walks.
+     */
+    void walkTo(const Vector2<int> destination) { m_checkpoints.assign(1, destination); m_nextCheckpoint = 0; }
+
+    /**
+     * @brief Appends checkpoints to the walk in progress, or starts one.
+     */
+    void extendWalk(const std::vector<Vector2<int>>& path) { m_checkpoints.insert(m_checkpoints.end(), path.begin(), path.end()); }
+    [[nodiscard]] size_t getRemainingCheckpoints() const { return m_checkpoints.size() - m_nextCheckpoint; }
+
+    /**
+     * @brief Walking, or one update short of settling: until then it is still drawn interpolated.
+     */
+    [[nodiscard]] bool isMoving() const override { return !m_checkpoints.empty() || m_previousCoordinates != m_coordinates; }
+    [[nodiscard]] std::span<const Vector2<int>> getPendingCheckpoints() const { return std::span(m_checkpoints).subspan(m_nextCheckpoint); }
+    void setCoordinates(Vector2<double> coordinates) override;
+
+    /**
+     * @param interpolation fraction of a timestep elapsed since the last update, in [0, 1)
+     */
+    [[nodiscard]] SDL_Rect getRenderRect(double interpolation) const override;
     virtual void handleEvent(const SDL_Event& event) {}
     void setSpeed(const double speed) { m_speed = speed; }
     [[nodiscard]] double getSpeed() const { return m_speed; }
+    [[nodiscard]] PhysicsType getPhysicsType() const { return m_physicsType; }
 protected:
     std::vector<Vector2<int>> m_checkpoints;
+    size_t m_nextCheckpoint{};
+    Vector2<double> m_previousCoordinates{};     // Position before the last update, for interpolation
     double m_speed;
     PhysicsType m_physicsType;
 };
@@ -223,26 +297,134 @@ protected:
 class GameBoard : public Observer
 {
 public:
-    GameBoard(const std::string& path, const std::shared_ptr<Player>& player, SDL_Renderer* cacheRenderer);
+    /**
+     * @param eventBus receives TilePushed, BlockReachedGoal, LevelSolved and the objects' WalkFinished
+     */
+    GameBoard(const std::string& path, const std::shared_ptr<Player>& player, SDL_Renderer* cacheRenderer,
+        GameEventBus* eventBus = nullptr);
     void update(const GameState& state);
-    void onClick(const GameState& state);
-    void pushTile(const std::shared_ptr<Sprite>& entity, const Vector2<int>& playerPosition) const;
-    void readDimensions(const std::string& path);
-    [[nodiscard]] static Vector2<int> snapScreenCoordinates(Vector2<int> coordinates);
-    [[nodiscard]] static Vector2<int> centerScreenCoordinates(Vector2<int> coordinates, const SDL_Rect& spriteDimensions);
-    Vector2<int> getGameBoardCoordinates(Vector2<int> coordinates) const;
+    /**
+     * @return true if the click started a walk or a push, i.e. the next frame shows a response
+     */
+    bool onClick(const GameState& state);
+    /**
+     * @return true if the entity was pushed; immovable objects, blocks out of reach and blocks with nowhere to slide stay put
+     */
+    bool pushTile(const std::shared_ptr<Sprite>& entity, const Vector2<int>& playerPosition);
+
+    /**
+     * @brief Re-reads the level file and rebuilds only the cells whose keys changed.
+     * At the same size the snapshot and the tables derived from it are patched cell by cell;
+     * a resize rebuilds the whole board. The live board is left untouched if the file fails to parse.
+     * @return newly created tiles and objects, which still need their textures cached
+     */
+    std::vector<std::shared_ptr<Entity>> reload(const std::string& path);
+    [[nodiscard]] static constexpr Vector2<int> snapScreenCoordinates(const Vector2<int> coordinates) { return TileGeometry::snapScreenCoordinates(coordinates); }
+    [[nodiscard]] static constexpr Vector2<int> centerScreenCoordinates(const Vector2<int> coordinates, const SDL_Rect& spriteDimensions) { return TileGeometry::centerScreenCoordinates(coordinates, spriteDimensions); }
+    [[nodiscard]] static constexpr Vector2<int> getGameBoardCoordinates(const Vector2<int> coordinates) { return TileGeometry::toBoardCoordinates(coordinates); }
     [[nodiscard]] std::shared_ptr<Tile> getEnclosingTile(const Vector2<int>& position) const;
     [[nodiscard]] std::shared_ptr<Tile> getTile(int x, int y) const;
     [[nodiscard]] std::vector<std::shared_ptr<Tile>> getTiles() const;
+    [[nodiscard]] const DynamicBoard& getTileGrid() const { return m_tiles; }
+
+    /**
+     * @brief The objects update() steps; all others are at rest on the tile they reside on.
+     */
+    [[nodiscard]] const std::vector<std::shared_ptr<GameObject>>& getMovingObjects() const { return m_movingObjects; }
+
+    /**
+     * @brief Board coordinates of tiles whose appearance changed since the last clearDirtyTiles.
+     */
+    [[nodiscard]] const std::vector<Vector2<int>>& getDirtyTiles() const { return m_dirtyTiles; }
+    void clearDirtyTiles() { m_dirtyTiles.clear(); }
+    [[nodiscard]] std::vector<std::shared_ptr<GameObject>> getObjects() const;
     //[[nodiscard]] Vector2<int> getTileCoordinates(const std::shared_ptr<Tile>& tile) const;
     [[nodiscard]] std::shared_ptr<Tile> getClosestAvailableTile(const Vector2<int>& tilePosition, const Vector2<int>& playerCoordinates) const;
+    /**
+     * @brief Shortest walk between two tiles using the board's pathfinding method.
+     * @return every tile from start to goal inclusive, empty if the goal can't be reached
+     */
     [[nodiscard]] std::vector<std::shared_ptr<Tile>> getPathToTile(const std::shared_ptr<Tile>& startTile, const std::shared_ptr<Tile>& goalTile) const;
-    [[nodiscard]] bool isSolved();
+    [[nodiscard]] std::vector<std::shared_ptr<Tile>> getPathToTile(const std::shared_ptr<Tile>& startTile, const std::shared_ptr<Tile>& goalTile, PathfindingMethod method) const;
+    void setPathfindingMethod(const PathfindingMethod method) { m_pathfindingMethod = method; }
+
+    /**
+     * @return milliseconds the latest path query or route refinement took
+     */
+    [[nodiscard]] double getLastPathQueryTime() const { return m_lastPathQueryTime; }
+    [[nodiscard]] PathfindingMethod getPathfindingMethod() const { return m_pathfindingMethod; }
+
+    /**
+     * @brief Hands an object to the cooperative planner, which walks it to goal without meeting other movers.
+     * The board updates it but doesn't draw it; add it to a render layer.
+     */
+    CooperativePlanner::AgentId addMover(const std::shared_ptr<GameObject>& object, const Vector2<int>& cell, const Vector2<int>& goal);
+    void setMoverGoal(const CooperativePlanner::AgentId mover, const Vector2<int>& goal) { m_planner.setGoal(mover, getCellIndex(goal)); }
+
+    /**
+     * @brief Plans waiting movers on the worker threads, within the budget; call once per frame.
+     */
+    void planMovers() { m_planner.plan(); }
+    void setMoverBudget(const size_t expansions) { m_planner.setBudget(expansions); }
+
+    /**
+     * @brief Runs a scripted sequence, resumed from update() until it finishes.
+     */
+    ActionScheduler::TaskId startAction(ActionTask action) { return m_actions.start(std::move(action)); }
+    void cancelAction(const ActionScheduler::TaskId action) { m_actions.cancel(action); }
+    [[nodiscard]] bool isActionRunning(const ActionScheduler::TaskId action) const { return m_actions.isRunning(action); }
+    /**
+     * @brief O(1); a board without goal tiles counts as solved.
+     */
+    [[nodiscard]] bool isSolved() const { return m_occupancy.filledGoals == m_occupancy.goalCount; }
+    [[nodiscard]] int getFilledGoalCount() const { return m_occupancy.filledGoals; }
+    [[nodiscard]] int getGoalCount() const { return m_occupancy.goalCount; }
+
+    /**
+     * @brief Zobrist hash of which cells hold an object, for repetition detection and state caching.
+     */
+    [[nodiscard]] uint64_t getOccupancyHash() const { return m_occupancy.hash; }
+
+    /**
+     * @brief Shares the current occupancy; the board copies it before its next change.
+     */
+    [[nodiscard]] std::shared_ptr<const BoardSnapshot> captureSnapshot() const { return m_snapshot; }
+    [[nodiscard]] uint64_t getSnapshotVersion() const { return m_snapshot->version; }
+
+    /**
+     * @brief FNV-1a of the level file's keys; saves only load onto the layout they were taken on.
+     */
+    [[nodiscard]] uint64_t getLayoutHash() const { return m_layoutHash; }
+
+    /**
+     * @brief Copies where the player is and where it is walking to. The occupancy and object records are
+     * shared, not copied; only blocks pushed since the last capture are brought up to date.
+     */
+    [[nodiscard]] SaveState captureSaveState(const std::string& levelPath);
+
+    /**
+     * @brief Moves the player and every object to where the save has them.
+     * The save is validated in full before the board is touched.
+     * @throws std::runtime_error if the save was taken on another layout or its objects don't add up
+     */
+    void restore(const SaveFile& save);
+
+    /**
+     * @brief Highlights the block a hint refers to. Stale hints are ignored.
+     */
+    void showHint(const Hint& hint);
+    void clearHint();
     [[nodiscard]] int getBoardRows() const { return m_boardRows; }
     [[nodiscard]] int getBoardColumns() const { return m_boardColumns; }
     [[nodiscard]] Vector2<int> getBoardBounds() const { return m_boardBounds; }
-    static constexpr int MAX_ROWS = 7;
-    static constexpr int MAX_COLUMNS = 7;
+    // Boards larger than the window are scrolled by the camera. Not 1024 yet: every chunk visited keeps its
+    // 2752 x 2048 target texture (22 MB), and CooperativePlanner's 16-bit distances overflow on a 1024 x 1024 maze
+    static constexpr int MAX_ROWS = 256;
+    static constexpr int MAX_COLUMNS = 256;
+    static constexpr size_t HIERARCHICAL_MIN_TILES = 128 * 128;  // Boards this large default to PathfindingMethod::Hierarchical
+    static constexpr size_t REFINE_AHEAD = 2;                    // Checkpoints left when the next sector of a walk is refined
+    static constexpr double MOVER_STEP_TIME = 0.25;              // Seconds per tile; movers step in lockstep
+    static constexpr size_t PATCH_COST_IN_CELLS = 1024;          // A patched cell costs about this many cells of a full rebuild
 
 private:
     SDL_Renderer* m_cacheRenderer;
@@ -251,8 +433,28 @@ private:
     Vector2<int> m_boardBounds{};
 
     std::shared_ptr<Entity> m_hoveredEntity;
+    std::shared_ptr<Sprite> m_hintedEntity;
+    std::shared_ptr<BoardSnapshot> m_snapshot;
+    SaveRecords m_saveRecords;                                   // Rebuilt with the snapshot, patched by pushTile and reload
     std::shared_ptr<Player> m_player;                            // Player sprite
-    std::vector<std::vector<std::shared_ptr<Tile>>> m_tiles;
+    DynamicBoard m_tiles;
+    TileGrid<std::shared_ptr<GameObject>> m_objects;          // Objects by the cell they were spawned on
+    std::vector<std::shared_ptr<GameObject>> m_movingObjects;    // Rebuilt with the snapshot, added to by pushTile
+
+    LevelLayers m_layers;                                        // Asset ids as last read from the level file
+    uint64_t m_layoutHash{};                                     // Of m_layers
+    std::vector<Vector2<int>> m_dirtyTiles;
+    BoardOccupancy m_occupancy;                                  // Updated by the tiles themselves
+    JumpPointGrid m_jumpPoints;                                  // Rebuilt with the snapshot, patched by pushTile and reload
+    SectorGraph m_sectors;                                       // Likewise
+    SectorRoute m_playerRoute;                                   // Hierarchical walk in progress
+    CooperativePlanner m_planner;                                // Reservations for the movers, by cell and step
+    ActionScheduler m_actions;                                   // Sequences spanning several updates
+    ActionScheduler::TaskId m_playerAction{};                    // Replaced by the next click
+    std::vector<std::shared_ptr<GameObject>> m_movers;           // By agent id
+    double m_moverClock{};
+    PathfindingMethod m_pathfindingMethod = PathfindingMethod::JumpPoint;
+    mutable double m_lastPathQueryTime{};                        // Written by const queries too
 
     struct AStarNode
     {
@@ -276,8 +478,38 @@ private:
         double m_hValue;
     };
 
-    static std::vector<std::vector<std::string>> loadMatrix(const std::string& path, int offset, int expectedRows, int expectedColumns);
+    static LevelLayers loadLayers(const std::string& path);
+    static uint64_t hashLayers(const LevelLayers& layers);
+    void applyDimensions(int rows, int columns);
+    [[nodiscard]] std::shared_ptr<Tile> createTile(AssetId asset, int x, int y);
+    [[nodiscard]] std::shared_ptr<GameObject> createObject(AssetId asset, GameObject::PhysicsType type, int x, int y) const;
+    void placeObject(int x, int y);
+    void rebuildSnapshot();
+    void rebuildSaveRecords();
+    [[nodiscard]] SaveObject makeSaveRecord(const GameObject& object, int32_t spawnCell) const;
+    [[nodiscard]] int32_t getRestingCell(const GameObject& object) const;
+
+    /**
+     * @brief Refreshes the snapshot and its derived tables at the given cells, or rebuilds them all
+     * once patching would cost more. Sorts and deduplicates cells.
+     */
+    void patchCells(std::vector<int32_t>& cells);
+    [[nodiscard]] static uint8_t getCellFlags(const Tile& tile);
+    BoardSnapshot& editSnapshot();
+    [[nodiscard]] int32_t getCellIndex(const Vector2<int>& boardCoordinates) const { return boardCoordinates.y * m_tiles.columns() + boardCoordinates.x; }
+    /**
+     * @return cell the object was freed from, -1 if it wasn't residing on a tile
+     */
+    int32_t removeObject(int x, int y);
+    void markDirty(const std::shared_ptr<Entity>& entity);
     static std::vector<std::shared_ptr<Tile>> reversePath(const std::shared_ptr<AStarNode>& node);
     static double heuristic(const Vector2<int>& a, const Vector2<int>& b);
     [[nodiscard]] std::vector<std::shared_ptr<Tile>> getNeighborTiles(const std::shared_ptr<Tile>& tile) const;
+    [[nodiscard]] std::vector<std::shared_ptr<Tile>> findPathAStar(const std::shared_ptr<Tile>& startTile, const std::shared_ptr<Tile>& goalTile) const;
+    [[nodiscard]] std::vector<std::shared_ptr<Tile>> getTilesAt(const std::vector<int32_t>& cells) const;
+    [[nodiscard]] std::vector<Vector2<int>> getCheckpoints(const std::vector<int32_t>& cells, const Sprite& walker) const;
+    [[nodiscard]] Vector2<int> getCellCenter(int32_t cell, const Sprite& walker) const;
+    bool startPlayerRoute(const std::shared_ptr<Tile>& goalTile);
+    ActionTask walkAndPush(std::shared_ptr<Sprite> block, std::shared_ptr<Tile> standTile);
+    void continuePlayerRoute();
 };
\ No newline at end of file
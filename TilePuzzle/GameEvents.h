@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include "EventBus.h"
+
+class Entity;
+
+// Cells are board indices, y * columns + x, as in BoardSnapshot
+
+struct TilePushed
+{
+    int32_t fromCell;
+    int32_t toCell;
+};
+
+struct BlockReachedGoal
+{
+    int32_t cell;
+};
+
+struct LevelSolved
+{
+    uint64_t boardVersion;                                       // Snapshot version of the solved board
+    uint64_t occupancyHash;
+};
+
+struct WalkFinished
+{
+    const Entity* walker;
+    int32_t x;                                                   // Final window coordinates
+    int32_t y;
+};
+
+using GameEventBus = EventBus<1024, TilePushed, BlockReachedGoal, LevelSolved, WalkFinished>;
@@ -1,8 +1,10 @@
 #pragma once
+#include <chrono>
 #include "Vector2.h"
 
 struct GameState
 {
     Vector2<int> mousePosition;
     double deltaTime;
+    std::chrono::steady_clock::time_point inputTime; // When the event being handled was generated
 };
@@ -0,0 +1,231 @@
+#include "HintSolver.h"
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+    struct SearchNode
+    {
+        std::vector<int32_t> blocks;  // Sorted block cells
+        int32_t player{};
+        int32_t parent = -1;
+        int32_t pushedBlock = -1;     // Block cell before the push that led here
+        int direction{};
+    };
+
+    // Marks every cell the player can walk to
+    void findReachable(const BoardSnapshot& snapshot, const std::vector<uint8_t>& occupied, const int32_t player,
+        std::vector<uint8_t>& reachable, std::vector<int32_t>& queue)
+    {
+        std::fill(reachable.begin(), reachable.end(), 0);
+        size_t head = 0;
+        queue.clear();
+        queue.push_back(player);
+        reachable[player] = 1;
+
+        while (head < queue.size())
+        {
+            const int32_t cell = queue[head++];
+            for (int direction = 0; direction < 4; ++direction)
+            {
+                const int32_t next = snapshot.neighbor(cell, direction);
+                if (next < 0 || reachable[next] || occupied[next])
+                    continue;
+                reachable[next] = 1;
+                queue.push_back(next);
+            }
+        }
+    }
+
+    // Two states are equal if they have the same blocks and the player can reach the same region
+    std::string makeKey(const std::vector<int32_t>& blocks, const std::vector<uint8_t>& reachable)
+    {
+        const auto region = static_cast<int32_t>(std::find(reachable.begin(), reachable.end(), 1) - reachable.begin());
+        std::string key(reinterpret_cast<const char*>(blocks.data()), blocks.size() * sizeof(int32_t));
+        key.append(reinterpret_cast<const char*>(&region), sizeof(region));
+        return key;
+    }
+}
+
+HintSolver::HintSolver()
+{
+    // Started here rather than in the initializer list, once every member it uses exists
+    m_thread = std::thread(&HintSolver::workerLoop, this);
+}
+
+HintSolver::~HintSolver()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    cancel();
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void HintSolver::request(std::shared_ptr<const BoardSnapshot> snapshot)
+{
+    {
+        // Bumped under the lock so the worker reads the snapshot and its generation together
+        std::lock_guard lock(m_mutex);
+        m_pending = std::move(snapshot);
+        m_generation.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_wake.notify_one();
+}
+
+void HintSolver::cancel()
+{
+    std::lock_guard lock(m_mutex);
+    m_pending.reset();
+    m_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+void HintSolver::workerLoop()
+{
+    AllocationTracker::Scope scope(AllocationCategory::Pathfinding);
+    while (true)
+    {
+        std::shared_ptr<const BoardSnapshot> snapshot;
+        uint64_t generation;
+        {
+            std::unique_lock lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || m_pending; });
+            if (m_stopping)
+                return;
+            snapshot = std::move(m_pending);
+            generation = m_generation.load(std::memory_order_relaxed);
+        }
+
+        const auto isCancelled = [this, generation] { return m_generation.load(std::memory_order_relaxed) != generation; };
+        if (std::optional<Hint> hint = solve(*snapshot, isCancelled))
+            m_results.push(*hint);
+    }
+}
+
+std::optional<Hint> HintSolver::solve(const BoardSnapshot& snapshot, const std::function<bool()>& isCancelled)
+{
+    const size_t cellCount = snapshot.cells.size();
+    std::vector<int32_t> goals;
+    std::vector<uint8_t> walls(cellCount);
+    SearchNode root;
+    root.player = snapshot.playerCell;
+
+    for (int32_t cell = 0; cell < static_cast<int32_t>(cellCount); ++cell)
+    {
+        const uint8_t flags = snapshot.cells[cell];
+        walls[cell] = (flags & BoardSnapshot::WallFlag) != 0;
+        if (flags & BoardSnapshot::BlockFlag)
+            root.blocks.push_back(cell);
+        if ((flags & BoardSnapshot::GoalFlag) && !walls[cell])
+            goals.push_back(cell);
+    }
+
+    Hint hint;
+    hint.version = snapshot.version;
+    if (goals.empty())
+        return hint;
+
+    const auto isSolved = [&goals](const std::vector<int32_t>& blocks)
+    {
+        return std::all_of(goals.begin(), goals.end(), [&blocks](const int32_t goal)
+        {
+            return std::binary_search(blocks.begin(), blocks.end(), goal);
+        });
+    };
+
+    if (isSolved(root.blocks))
+        return hint;
+
+    std::vector<uint8_t> occupied(cellCount);
+    std::vector<uint8_t> reachable(cellCount);
+    std::vector<int32_t> queue;
+    std::vector<uint8_t> childOccupied(cellCount);
+    std::vector<uint8_t> childReachable(cellCount);
+    queue.reserve(cellCount);
+
+    const auto loadOccupancy = [&](const std::vector<int32_t>& blocks)
+    {
+        occupied = walls;
+        for (const int32_t block : blocks)
+            occupied[block] = 1;
+    };
+
+    std::vector<SearchNode> nodes;
+    std::unordered_set<std::string> visited;
+    loadOccupancy(root.blocks);
+    findReachable(snapshot, occupied, root.player, reachable, queue);
+    visited.insert(makeKey(root.blocks, reachable));
+    nodes.push_back(std::move(root));
+
+    for (size_t current = 0; current < nodes.size() && nodes.size() < MAX_STATES; ++current)
+    {
+        if ((current & 255) == 0 && isCancelled())
+            return std::nullopt;
+
+        const std::vector<int32_t> blocks = nodes[current].blocks;
+        loadOccupancy(blocks);
+        findReachable(snapshot, occupied, nodes[current].player, reachable, queue);
+
+        for (size_t i = 0; i < blocks.size(); ++i)
+        {
+            for (int direction = 0; direction < 4; ++direction)
+            {
+                // The player has to stand on the opposite side of the block
+                const int32_t side = snapshot.neighbor(blocks[i], 3 - direction);
+                if (side < 0 || !reachable[side])
+                    continue;
+
+                int32_t destination = blocks[i];
+                for (int32_t next = snapshot.neighbor(destination, direction);
+                     next >= 0 && !occupied[next];
+                     next = snapshot.neighbor(destination, direction))
+                {
+                    destination = next;
+                }
+
+                if (destination == blocks[i])
+                    continue;
+
+                SearchNode child;
+                child.blocks = blocks;
+                child.blocks[i] = destination;
+                std::sort(child.blocks.begin(), child.blocks.end());
+                child.player = side;
+                child.parent = static_cast<int32_t>(current);
+                child.pushedBlock = blocks[i];
+                child.direction = direction;
+
+                if (isSolved(child.blocks))
+                {
+                    // Walk back to the push made from the root
+                    int pushes = 1;
+                    const SearchNode* first = &child;
+                    while (first->parent != 0)
+                    {
+                        first = &nodes[first->parent];
+                        ++pushes;
+                    }
+                    hint.blockCell = first->pushedBlock;
+                    hint.direction = first->direction;
+                    hint.pushes = pushes;
+                    return hint;
+                }
+
+                childOccupied = walls;
+                for (const int32_t block : child.blocks)
+                    childOccupied[block] = 1;
+                findReachable(snapshot, childOccupied, child.player, childReachable, queue);
+
+                if (visited.insert(makeKey(child.blocks, childReachable)).second)
+                    nodes.push_back(std::move(child));
+            }
+        }
+    }
+
+    return hint;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include "BoardSnapshot.h"
+#include "SpscQueue.h"
+
+struct Hint
+{
+    uint64_t version{};      // Snapshot version the hint was computed for
+    int32_t blockCell = -1;  // Block to push, -1 if no solution was found within the search limit
+    int direction{};         // Up, left, right, down
+    int pushes{};            // Pushes left in the shortest solution, including this one
+};
+
+/**
+ * @brief Searches for the next optimal push on a worker thread.
+ * A new request cancels the search in progress. Results are delivered through a lock-free queue and
+ * carry the snapshot version so the caller can drop hints for a board that has changed since.
+ */
+class HintSolver
+{
+public:
+    static constexpr size_t MAX_STATES = 200000;
+
+    HintSolver();
+    ~HintSolver();
+
+    HintSolver(const HintSolver&) = delete;
+    HintSolver& operator=(const HintSolver&) = delete;
+
+    void request(std::shared_ptr<const BoardSnapshot> snapshot);
+    void cancel();
+    std::optional<Hint> poll() { return m_results.pop(); }
+
+    /**
+     * @brief Breadth-first search over pushes, the player walking freely between them.
+     * @return std::nullopt if cancelled
+     */
+    static std::optional<Hint> solve(const BoardSnapshot& snapshot, const std::function<bool()>& isCancelled);
+
+private:
+    void workerLoop();
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::shared_ptr<const BoardSnapshot> m_pending;
+    std::atomic<uint64_t> m_generation{ 0 };
+    bool m_stopping{};
+    SpscQueue<Hint, 16> m_results;
+};
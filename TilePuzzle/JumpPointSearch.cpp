@@ -0,0 +1,293 @@
+#include "JumpPointSearch.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <queue>
+
+namespace
+{
+    constexpr int DX[] = { 0, -1, 1, 0 };
+    constexpr int DY[] = { -1, 0, 0, 1 };
+    constexpr uint8_t ALL_DIRECTIONS = 0b1111;
+
+    thread_local size_t g_lastExpandedCount = 0;
+
+    struct OpenNode
+    {
+        int f{};
+        int g{};
+        int32_t cell{};
+
+        // Lowest f first, deeper nodes first among equals
+        bool operator>(const OpenNode& other) const { return f != other.f ? f > other.f : g < other.g; }
+    };
+
+    constexpr bool isHorizontal(const int direction) { return direction == JumpPointGrid::Left || direction == JumpPointGrid::Right; }
+}
+
+void JumpPointGrid::rebuild(const BoardSnapshot& snapshot)
+{
+    m_columns = snapshot.columns;
+    m_rows = snapshot.rows;
+    m_blocked.resize(snapshot.cells.size());
+    for (size_t i = 0; i < snapshot.cells.size(); ++i)
+        m_blocked[i] = (snapshot.cells[i] & (BoardSnapshot::WallFlag | BoardSnapshot::BlockFlag)) != 0;
+
+    m_distances.assign(m_blocked.size() * DIRECTION_COUNT, 0);
+    m_hadJump.assign(static_cast<size_t>(std::min(m_rows, 3)) * m_columns, 0);
+    // Vertical distances depend on the horizontal ones
+    for (int y = 0; y < m_rows; ++y)
+        computeRow(y);
+    for (int x = 0; x < m_columns; ++x)
+        computeColumn(x);
+}
+
+void JumpPointGrid::setBlocked(const int32_t cell, const bool blocked)
+{
+    if (isBlocked(cell) == blocked)
+        return;
+    m_blocked[cell] = blocked;
+
+    const int x = cell % m_columns;
+    const int y = cell / m_columns;
+
+    // Horizontal runs only look at the rows directly above and below them
+    const int firstRow = std::max(y - 1, 0);
+    const int lastRow = std::min(y + 1, m_rows - 1);
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        for (int column = 0; column < m_columns; ++column)
+            m_hadJump[(row - firstRow) * m_columns + column] = hasHorizontalJump(column, row);
+    }
+
+    for (int row = firstRow; row <= lastRow; ++row)
+        computeRow(row);
+
+    // Columns are only affected where a cell gained or lost a horizontal jump, or through the cell itself
+    for (int column = 0; column < m_columns; ++column)
+    {
+        bool changed = column == x;
+        for (int row = firstRow; row <= lastRow && !changed; ++row)
+            changed = m_hadJump[(row - firstRow) * m_columns + column] != hasHorizontalJump(column, row);
+        if (changed)
+            computeColumn(column);
+    }
+}
+
+std::vector<int32_t> JumpPointGrid::findPath(const int32_t start, const int32_t goal) const
+{
+    g_lastExpandedCount = 0;
+    const auto cellCount = static_cast<int32_t>(m_blocked.size());
+    if (start < 0 || goal < 0 || start >= cellCount || goal >= cellCount || isBlocked(goal))
+        return {};
+    if (start == goal)
+        return { start };
+
+    const int goalX = goal % m_columns;
+    const int goalY = goal / m_columns;
+    auto heuristic = [&](const int32_t cell)
+    {
+        return std::abs(cell % m_columns - goalX) + std::abs(cell / m_columns - goalY);
+    };
+
+    // Next jump point from cell in direction, or -1 if the run ends without one
+    auto jump = [&](const int32_t cell, const int direction) -> int32_t
+    {
+        const int x = cell % m_columns;
+        const int y = cell / m_columns;
+        const int distance = getJumpDistance(cell, static_cast<Direction>(direction));
+        const int reach = std::abs(distance);
+
+        if (isHorizontal(direction))
+        {
+            const int toGoal = (goalX - x) * DX[direction];
+            if (goalY == y && toGoal > 0 && toGoal <= reach)
+                return goal;
+        }
+        else
+        {
+            // Stop on the goal's row so the horizontal scan from there can find it
+            const int toGoalRow = (goalY - y) * DY[direction];
+            if (toGoalRow > 0 && toGoalRow <= reach)
+                return (y + toGoalRow * DY[direction]) * m_columns + x;
+        }
+
+        if (distance <= 0)
+            return -1;
+        return (y + distance * DY[direction]) * m_columns + x + distance * DX[direction];
+    };
+
+    // Directions worth expanding from a jump point reached by travelling in direction
+    auto successorDirections = [&](const int32_t cell, const int direction) -> uint8_t
+    {
+        if (!isHorizontal(direction))
+            return (1 << direction) | (1 << Left) | (1 << Right);
+
+        const int x = cell % m_columns;
+        const int y = cell / m_columns;
+        const int previousX = x - DX[direction];
+        uint8_t directions = 1 << direction;
+        if (isFree(x, y - 1) && !isFree(previousX, y - 1))
+            directions |= 1 << Up;
+        if (isFree(x, y + 1) && !isFree(previousX, y + 1))
+            directions |= 1 << Down;
+        return directions;
+    };
+
+    std::vector<int> gScores(cellCount, std::numeric_limits<int>::max());
+    std::vector<int32_t> parents(cellCount, -1);
+    std::vector<uint8_t> pending(cellCount);   // Directions to expand, merged when a cell is reached again at equal cost
+    std::vector<uint8_t> expanded(cellCount);
+    std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<>> openList;
+
+    gScores[start] = 0;
+    pending[start] = ALL_DIRECTIONS;
+    openList.push({ heuristic(start), 0, start });
+
+    while (!openList.empty())
+    {
+        const OpenNode current = openList.top();
+        openList.pop();
+        if (current.g > gScores[current.cell])
+            continue;
+
+        if (current.cell == goal)
+        {
+            std::vector<int32_t> path;
+            for (int32_t cell = goal; parents[cell] >= 0; cell = parents[cell])
+            {
+                // Fill in the straight run back to the previous jump point
+                const int32_t parent = parents[cell];
+                const int32_t step = cell % m_columns != parent % m_columns
+                    ? (cell > parent ? 1 : -1)
+                    : (cell > parent ? m_columns : -m_columns);
+                for (int32_t walk = cell; walk != parent; walk -= step)
+                    path.push_back(walk);
+            }
+            path.push_back(start);
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+
+        const uint8_t directions = pending[current.cell] & ~expanded[current.cell];
+        if (!directions)
+            continue;
+        expanded[current.cell] |= directions;
+        ++g_lastExpandedCount;
+
+        for (int direction = 0; direction < DIRECTION_COUNT; ++direction)
+        {
+            if (!(directions & (1 << direction)))
+                continue;
+
+            const int32_t next = jump(current.cell, direction);
+            if (next < 0)
+                continue;
+
+            const int g = current.g + std::abs(next % m_columns - current.cell % m_columns)
+                + std::abs(next / m_columns - current.cell / m_columns);
+            const uint8_t nextDirections = successorDirections(next, direction);
+
+            if (g < gScores[next])
+            {
+                gScores[next] = g;
+                parents[next] = current.cell;
+                pending[next] = nextDirections;
+                expanded[next] = 0;
+                openList.push({ g + heuristic(next), g, next });
+            }
+            else if (g == gScores[next] && (nextDirections & ~pending[next]))
+            {
+                pending[next] |= nextDirections;
+                openList.push({ g + heuristic(next), g, next });
+            }
+        }
+    }
+    return {};
+}
+
+size_t JumpPointGrid::getLastExpandedCount()
+{
+    return g_lastExpandedCount;
+}
+
+bool JumpPointGrid::isFree(const int x, const int y) const
+{
+    return x >= 0 && x < m_columns && y >= 0 && y < m_rows && !m_blocked[y * m_columns + x];
+}
+
+bool JumpPointGrid::hasHorizontalJump(const int x, const int y) const
+{
+    const int32_t cell = y * m_columns + x;
+    return getJumpDistance(cell, Left) > 0 || getJumpDistance(cell, Right) > 0;
+}
+
+void JumpPointGrid::computeRow(const int y)
+{
+    // A horizontal run stops where a wall above or below it ends
+    auto isForced = [&](const int x, const int previousX)
+    {
+        return (isFree(x, y - 1) && !isFree(previousX, y - 1)) ||
+               (isFree(x, y + 1) && !isFree(previousX, y + 1));
+    };
+
+    for (int x = m_columns - 1; x >= 0; --x)
+    {
+        int16_t& value = distance(x, y, Right);
+        if (!isFree(x + 1, y))
+            value = 0;
+        else if (isForced(x + 1, x))
+            value = 1;
+        else
+        {
+            const int16_t next = distance(x + 1, y, Right);
+            value = next > 0 ? next + 1 : next - 1;
+        }
+    }
+
+    for (int x = 0; x < m_columns; ++x)
+    {
+        int16_t& value = distance(x, y, Left);
+        if (!isFree(x - 1, y))
+            value = 0;
+        else if (isForced(x - 1, x))
+            value = 1;
+        else
+        {
+            const int16_t next = distance(x - 1, y, Left);
+            value = next > 0 ? next + 1 : next - 1;
+        }
+    }
+}
+
+void JumpPointGrid::computeColumn(const int x)
+{
+    // A vertical run stops on every cell whose row scan finds a jump point
+    for (int y = 0; y < m_rows; ++y)
+    {
+        int16_t& value = distance(x, y, Up);
+        if (!isFree(x, y - 1))
+            value = 0;
+        else if (hasHorizontalJump(x, y - 1))
+            value = 1;
+        else
+        {
+            const int16_t next = distance(x, y - 1, Up);
+            value = next > 0 ? next + 1 : next - 1;
+        }
+    }
+
+    for (int y = m_rows - 1; y >= 0; --y)
+    {
+        int16_t& value = distance(x, y, Down);
+        if (!isFree(x, y + 1))
+            value = 0;
+        else if (hasHorizontalJump(x, y + 1))
+            value = 1;
+        else
+        {
+            const int16_t next = distance(x, y + 1, Down);
+            value = next > 0 ? next + 1 : next - 1;
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BoardSnapshot.h"
+
+/**
+ * @brief Jump Point Search for the 4-connected, uniform-cost board.
+ * Canonical paths travel vertically first and only turn vertical again after a horizontal run
+ * where a wall ends, so every vertical step scans its row and horizontal runs stop only at those
+ * turns. Jump distances are precomputed per cell and direction (JPS+), and patched per row and
+ * column when a single cell changes, so pushing a block costs O(columns + k * rows).
+ */
+class JumpPointGrid
+{
+public:
+    // Same order as BoardSnapshot::neighbor
+    enum Direction : int { Up = 0, Left, Right, Down, DIRECTION_COUNT };
+
+    /**
+     * @brief Recomputes every distance; walls and blocks in the snapshot are obstacles.
+     */
+    void rebuild(const BoardSnapshot& snapshot);
+
+    /**
+     * @brief Marks a cell as free or obstructed and patches the distances that depend on it.
+     */
+    void setBlocked(int32_t cell, bool blocked);
+
+    /**
+     * @return every cell from start to goal inclusive, empty if the goal can't be reached
+     */
+    [[nodiscard]] std::vector<int32_t> findPath(int32_t start, int32_t goal) const;
+
+    /**
+     * @return steps to the next jump point if positive, otherwise minus the steps to the last free cell
+     */
+    [[nodiscard]] int getJumpDistance(const int32_t cell, const Direction direction) const { return m_distances[cell * DIRECTION_COUNT + direction]; }
+    [[nodiscard]] bool isBlocked(const int32_t cell) const { return m_blocked[cell] != 0; }
+    [[nodiscard]] int getColumns() const { return m_columns; }
+    [[nodiscard]] int getRows() const { return m_rows; }
+
+    /**
+     * @brief Nodes expanded by the last findPath on this thread, for benchmarks.
+     */
+    [[nodiscard]] static size_t getLastExpandedCount();
+
+private:
+    [[nodiscard]] bool isFree(int x, int y) const;
+    [[nodiscard]] bool hasHorizontalJump(int x, int y) const;
+    void computeRow(int y);
+    void computeColumn(int x);
+    int16_t& distance(const int x, const int y, const Direction direction) { return m_distances[(y * m_columns + x) * DIRECTION_COUNT + direction]; }
+
+    int m_columns{};
+    int m_rows{};
+    std::vector<uint8_t> m_blocked;   // y * columns + x
+    std::vector<int16_t> m_distances; // cell * DIRECTION_COUNT + direction
+    std::vector<uint8_t> m_hadJump;   // setBlocked's scratch: horizontal jumps of up to three rows, sized by rebuild
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <SDL.h>
+
+/**
+ * @brief Fixed-bucket latency histogram with 0.1 ms resolution up to one second.
+ * Recording never allocates; larger samples land in the last bucket but still update the maximum.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr double BUCKET_MS = 0.1;
+    static constexpr size_t BUCKET_COUNT = 10000;
+
+    void record(const double milliseconds)
+    {
+        const auto bucket = static_cast<size_t>(std::max(0.0, milliseconds) / BUCKET_MS);
+        ++m_buckets[std::min(bucket, BUCKET_COUNT - 1)];
+        ++m_count;
+        m_max = std::max(m_max, milliseconds);
+    }
+
+    /**
+     * @param fraction 0.5 for the median, 0.99 for p99
+     * @return upper edge of the bucket holding the requested percentile, in milliseconds
+     */
+    [[nodiscard]] double percentile(const double fraction) const
+    {
+        if (m_count == 0)
+            return 0.0;
+
+        const auto target = static_cast<uint64_t>(std::max(1.0, fraction * static_cast<double>(m_count)));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i)
+        {
+            seen += m_buckets[i];
+            if (seen >= target)
+                return std::min(m_max, static_cast<double>(i + 1) * BUCKET_MS);
+        }
+        return m_max;
+    }
+
+    [[nodiscard]] double max() const { return m_max; }
+    [[nodiscard]] uint64_t count() const { return m_count; }
+
+private:
+    std::array<uint32_t, BUCKET_COUNT> m_buckets{};
+    uint64_t m_count{};
+    double m_max{};
+};
+
+/**
+ * @brief Measures the time from an input event until the first SDL_RenderPresent that shows its effect.
+ */
+class LatencyTracker
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Converts an SDL event timestamp (milliseconds since SDL_Init) to the steady clock.
+     */
+    static clock::time_point fromEventTimestamp(const uint32_t eventTimestamp)
+    {
+        const uint32_t age = SDL_GetTicks() - eventTimestamp;
+        return clock::now() - std::chrono::milliseconds(age);
+    }
+
+    /**
+     * @brief Registers an input whose effect will be visible on the next present.
+     */
+    void markPending(const clock::time_point inputTime)
+    {
+        if (m_pendingCount < m_pending.size())
+            m_pending[m_pendingCount++] = inputTime;
+    }
+
+    /**
+     * @brief Call right after SDL_RenderPresent.
+     */
+    void onPresent()
+    {
+        if (m_pendingCount == 0)
+            return;
+
+        const clock::time_point now = clock::now();
+        for (size_t i = 0; i < m_pendingCount; ++i)
+        {
+            const std::chrono::duration<double, std::milli> latency = now - m_pending[i];
+            m_histogram.record(latency.count());
+        }
+        m_pendingCount = 0;
+    }
+
+    [[nodiscard]] const LatencyHistogram& getHistogram() const { return m_histogram; }
+
+    void report(std::ostream& os) const
+    {
+        os << "Input-to-present latency (" << m_histogram.count() << " samples): "
+           << "p50 " << m_histogram.percentile(0.5) << " ms, "
+           << "p99 " << m_histogram.percentile(0.99) << " ms, "
+           << "max " << m_histogram.max() << " ms\n";
+    }
+
+private:
+    std::array<clock::time_point, 64> m_pending{};
+    size_t m_pendingCount{};
+    LatencyHistogram m_histogram;
+};
@@ -0,0 +1,157 @@
+#include "LevelData.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include "AssetRegistry.h"
+
+namespace
+{
+    void report(std::vector<std::string>* errors, std::string message)
+    {
+        if (!errors)
+            throw std::runtime_error(message);
+        errors->push_back(std::move(message));
+    }
+
+    std::string describeCell(const int row, const int column)
+    {
+        return "Row " + std::to_string(row + 1) + ", column " + std::to_string(column + 1) + ": ";
+    }
+
+    void readDimensions(std::istream& file, const std::string& sourceName, const int maxRows, const int maxColumns, LevelLayers& layers)
+    {
+        std::string line;
+        std::getline(file, line);
+        std::stringstream dimensionsStream(line);
+        dimensionsStream >> layers.rows;
+        dimensionsStream.ignore(1);
+        dimensionsStream >> layers.columns;
+
+        if (layers.rows <= 0 || layers.columns <= 0 || layers.rows > maxRows || layers.columns > maxColumns)
+            throw std::runtime_error("Invalid board dimensions in file: " + sourceName);
+    }
+
+    std::vector<AssetId> loadMatrix(std::istream& file, const int expectedRows, const int expectedColumns,
+        int& lineNumber, std::vector<std::string>* errors)
+    {
+        const AssetRegistry& registry = AssetRegistry::getInstance();
+        std::vector<AssetId> matrix;
+        matrix.reserve(static_cast<size_t>(expectedRows) * expectedColumns);
+
+        // Read the matrix, skipping the blank lines that separate layers
+        std::string line;
+        int row = 0;
+        while (row < expectedRows)
+        {
+            if (!std::getline(file, line))
+                throw std::runtime_error("Unexpected end of file in matrix data");
+            ++lineNumber;
+
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+
+            if (line.empty()) continue;
+
+            // Intern keys straight from the line; like getline, a trailing comma doesn't add an empty cell
+            const std::string_view text = line;
+            int cells = 0;
+            for (size_t start = 0; start < text.size(); ++cells)
+            {
+                const size_t comma = std::min(text.find(',', start), text.size());
+                if (cells < expectedColumns)
+                {
+                    const std::string_view key = text.substr(start, comma - start);
+                    const AssetId id = registry.find(key);
+                    if (id == AssetRegistry::INVALID_ASSET)
+                    {
+                        report(errors, "Line " + std::to_string(lineNumber) + ", column " + std::to_string(cells + 1) +
+                            ": unknown key \"" + std::string(key) + "\"");
+                    }
+                    matrix.push_back(id);
+                }
+                start = comma + 1;
+            }
+
+            if (cells != expectedColumns)
+            {
+                report(errors, "Line " + std::to_string(lineNumber) + ": " + std::to_string(cells) + " cells, expected " +
+                    std::to_string(expectedColumns));
+                matrix.resize(static_cast<size_t>(row + 1) * expectedColumns, EMPTY_ASSET);
+            }
+            ++row;
+        }
+
+        return matrix;
+    }
+}
+
+LevelLayers loadLevelLayers(const std::string& path, const int maxRows, const int maxColumns, std::vector<std::string>* errors)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+        throw std::runtime_error("Could not open file: " + path);
+
+    return parseLevelLayers(file, path, maxRows, maxColumns, errors);
+}
+
+LevelLayers parseLevelLayers(std::istream& stream, const std::string& sourceName, const int maxRows, const int maxColumns,
+    std::vector<std::string>* errors)
+{
+    LevelLayers layers;
+    readDimensions(stream, sourceName, maxRows, maxColumns, layers);
+    int lineNumber = 1;
+    layers.tiles = loadMatrix(stream, layers.rows, layers.columns, lineNumber, errors);
+    layers.immovables = loadMatrix(stream, layers.rows, layers.columns, lineNumber, errors);
+    layers.movables = loadMatrix(stream, layers.rows, layers.columns, lineNumber, errors);
+    checkLayers(layers, errors);
+    return layers;
+}
+
+void checkLayers(const LevelLayers& layers, std::vector<std::string>* errors)
+{
+    const AssetRegistry& registry = AssetRegistry::getInstance();
+    for (int row = 0; row < layers.rows; ++row)
+    {
+        for (int column = 0; column < layers.columns; ++column)
+        {
+            const size_t cell = layers.index(row, column);
+            const AssetId tile = layers.tiles[cell];
+            const AssetId immovable = layers.immovables[cell];
+            const AssetId movable = layers.movables[cell];
+
+            // Unknown keys were reported as they were read
+            if (tile != AssetRegistry::INVALID_ASSET && registry.getTexturePath(tile).empty())
+                report(errors, describeCell(row, column) + "no tile");
+            if (immovable != EMPTY_ASSET && immovable != AssetRegistry::INVALID_ASSET && !registry.hasCollision(immovable, AssetRegistry::SolidCollision))
+                report(errors, describeCell(row, column) + registry.getKey(immovable) + " isn't solid, so it can't be an immovable object");
+            if (movable != EMPTY_ASSET && movable != AssetRegistry::INVALID_ASSET && !registry.hasCollision(movable, AssetRegistry::PushableCollision))
+                report(errors, describeCell(row, column) + registry.getKey(movable) + " isn't pushable, so it can't be a movable object");
+        }
+    }
+}
+
+std::vector<LevelFile> findLevelFiles(const std::vector<std::string>& inputs)
+{
+    std::vector<LevelFile> files;
+    for (const std::string& input : inputs)
+    {
+        if (!std::filesystem::is_directory(input))
+        {
+            files.push_back({ input, std::filesystem::path(input).filename().generic_string() });
+            continue;
+        }
+
+        std::vector<LevelFile> found;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(input))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == LevelLayers::FILE_EXTENSION)
+                found.push_back({ entry.path().generic_string(), std::filesystem::relative(entry.path(), input).generic_string() });
+        }
+        std::sort(found.begin(), found.end(), [](const LevelFile& a, const LevelFile& b) { return a.path < b.path; });
+        files.insert(files.end(), std::make_move_iterator(found.begin()), std::make_move_iterator(found.end()));
+    }
+    return files;
+}
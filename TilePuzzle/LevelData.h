@@ -0,0 +1,52 @@
+#pragma once
+#include <istream>
+#include <string>
+#include <vector>
+#include "TextureKeys.h"
+
+/**
+ * @brief Asset ids of each layer of a level file, independent of SDL.
+ * Cells are stored [row * columns + column] with rows as in the file; GameBoard maps the file row to the x axis.
+ */
+struct LevelLayers
+{
+    static constexpr const char* FILE_EXTENSION = ".txt";
+
+    int rows{};
+    int columns{};
+    std::vector<AssetId> tiles;
+    std::vector<AssetId> immovables;
+    std::vector<AssetId> movables;
+
+    [[nodiscard]] size_t index(const int row, const int column) const { return static_cast<size_t>(row) * columns + column; }
+};
+
+/**
+ * @brief Interns each key through AssetRegistry, then checks the result with checkLayers.
+ * @param errors if given, malformed rows, unknown keys and misplaced assets are reported here instead of
+ * thrown, so one pass finds all of them; rows are padded or cut to size and unknown keys read as
+ * AssetRegistry::INVALID_ASSET
+ * @throws std::runtime_error on unreadable files, bad dimensions, early ends or (without errors) any other problem
+ */
+LevelLayers loadLevelLayers(const std::string& path, int maxRows, int maxColumns, std::vector<std::string>* errors = nullptr);
+LevelLayers parseLevelLayers(std::istream& stream, const std::string& sourceName, int maxRows, int maxColumns,
+    std::vector<std::string>* errors = nullptr);
+
+/**
+ * @brief Checks each cell against the asset it names: every tile needs a texture, immovable objects
+ * must be solid and movable objects pushable.
+ * @param errors if given, problems are appended here instead of thrown
+ */
+void checkLayers(const LevelLayers& layers, std::vector<std::string>* errors = nullptr);
+
+struct LevelFile
+{
+    std::string path;
+    std::string name;                                            // Path relative to the directory it was found in
+};
+
+/**
+ * @brief Expands directories into the level files below them, sorted so results diff cleanly; files are kept as given.
+ * @throws std::filesystem::filesystem_error if a directory can't be listed
+ */
+std::vector<LevelFile> findLevelFiles(const std::vector<std::string>& inputs);
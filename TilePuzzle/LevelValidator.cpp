@@ -0,0 +1,227 @@
+#include "LevelValidator.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include "AssetRegistry.h"
+#include "EmbeddedLevels.h"
+#include "WorkerPool.h"
+
+namespace
+{
+    std::string describeCell(const int row, const int column)
+    {
+        return "Row " + std::to_string(row + 1) + ", column " + std::to_string(column + 1) + ": ";
+    }
+
+    void writeString(std::ostream& stream, const std::string& text)
+    {
+        stream << '"';
+        for (const char character : text)
+        {
+            switch (character)
+            {
+            case '"': stream << "\\\""; break;
+            case '\\': stream << "\\\\"; break;
+            case '\n': stream << "\\n"; break;
+            case '\r': stream << "\\r"; break;
+            case '\t': stream << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(character) < 0x20)
+                    stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(character) << std::dec << std::setfill(' ');
+                else
+                    stream << character;
+            }
+        }
+        stream << '"';
+    }
+}
+
+std::vector<std::string> LevelValidator::validate(const std::string& path)
+{
+    std::vector<std::string> errors;
+    try
+    {
+        const LevelLayers layers = loadLevelLayers(path, EmbeddedLevels::MAX_ROWS, EmbeddedLevels::MAX_COLUMNS, &errors);
+        validate(layers, errors);
+    }
+    catch (const std::exception& e)
+    {
+        // Nothing past a bad header or an early end can be checked
+        errors.emplace_back(e.what());
+    }
+    return errors;
+}
+
+void LevelValidator::validate(const LevelLayers& layers, std::vector<std::string>& errors)
+{
+    const AssetRegistry& registry = AssetRegistry::getInstance();
+    const int rows = layers.rows;
+    const int columns = layers.columns;
+    std::vector<uint8_t> walls(static_cast<size_t>(rows) * columns);
+    std::vector<std::pair<int, int>> goals;
+    int blocks = 0;
+
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int column = 0; column < columns; ++column)
+        {
+            const size_t cell = layers.index(row, column);
+            const bool hasImmovable = layers.immovables[cell] != EMPTY_ASSET;
+            const bool hasMovable = layers.movables[cell] != EMPTY_ASSET;
+            const bool isGoal = layers.tiles[cell] != AssetRegistry::INVALID_ASSET && registry.isGoal(layers.tiles[cell]);
+            if (hasImmovable && hasMovable)
+                errors.push_back(describeCell(row, column) + "both an immovable and a movable object");
+            if (isGoal && hasImmovable && !hasMovable)
+                errors.push_back(describeCell(row, column) + "goal covered by an immovable object");
+            if (row == 0 && column == 0 && (hasImmovable || hasMovable))
+                errors.push_back(describeCell(row, column) + "the player starts here, but an object does too");
+
+            // The movable layer wins when both are set, as in GameBoard
+            walls[cell] = hasImmovable && !hasMovable;
+            blocks += hasMovable;
+            if (isGoal)
+                goals.emplace_back(row, column);
+        }
+    }
+
+    if (blocks < static_cast<int>(goals.size()))
+        errors.push_back(std::to_string(goals.size()) + " goals but only " + std::to_string(blocks) + " movable objects");
+
+    // Blocks can be pushed out of the way, so only walls cut the player off
+    std::vector<uint8_t> reached(walls.size());
+    std::queue<std::pair<int, int>> frontier;
+    if (!walls[0])
+    {
+        reached[0] = true;
+        frontier.emplace(0, 0);
+    }
+    while (!frontier.empty())
+    {
+        const auto [row, column] = frontier.front();
+        frontier.pop();
+        for (const auto& [dRow, dColumn] : { std::pair{ -1, 0 }, std::pair{ 0, -1 }, std::pair{ 0, 1 }, std::pair{ 1, 0 } })
+        {
+            const int nextRow = row + dRow;
+            const int nextColumn = column + dColumn;
+            if (nextRow < 0 || nextColumn < 0 || nextRow >= rows || nextColumn >= columns)
+                continue;
+
+            const size_t cell = static_cast<size_t>(nextRow) * columns + nextColumn;
+            if (!walls[cell] && !reached[cell])
+            {
+                reached[cell] = true;
+                frontier.emplace(nextRow, nextColumn);
+            }
+        }
+    }
+
+    for (const auto& [row, column] : goals)
+    {
+        if (!reached[static_cast<size_t>(row) * columns + column])
+            errors.push_back(describeCell(row, column) + "goal unreachable from the player start");
+    }
+}
+
+void LevelValidator::writeReport(std::ostream& stream, const std::vector<Result>& results, const double elapsedMilliseconds)
+{
+    size_t invalid = 0;
+    for (const Result& result : results)
+        invalid += !result.errors.empty();
+
+    stream << "{\n  \"levels\": " << results.size() << ",\n  \"invalid\": " << invalid
+        << ",\n  \"elapsedMs\": " << std::fixed << std::setprecision(3) << elapsedMilliseconds << ",\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& result = results[i];
+        stream << (i ? ",\n" : "\n") << "    { \"path\": ";
+        writeString(stream, result.path);
+        stream << ", \"valid\": " << (result.errors.empty() ? "true" : "false") << ", \"errors\": [";
+        for (size_t j = 0; j < result.errors.size(); ++j)
+        {
+            stream << (j ? ", " : "");
+            writeString(stream, result.errors[j]);
+        }
+        stream << "] }";
+    }
+    stream << (results.empty() ? "]\n}\n" : "\n  ]\n}\n");
+}
+
+int LevelValidator::run(const std::vector<std::string>& arguments)
+{
+    std::vector<std::string> inputs;
+    std::string reportPath;
+    std::string manifestPath = AssetRegistry::DEFAULT_MANIFEST;
+    for (size_t i = 0; i < arguments.size(); ++i)
+    {
+        if (arguments[i] == "--report" && i + 1 < arguments.size())
+            reportPath = arguments[++i];
+        else if (arguments[i] == "--manifest" && i + 1 < arguments.size())
+            manifestPath = arguments[++i];
+        else
+            inputs.push_back(arguments[i]);
+    }
+    if (inputs.empty())
+    {
+        std::cerr << "Usage: TilePuzzle --validate-levels <file or directory>... [--report report.json] [--manifest manifest.txt]\n";
+        return 2;
+    }
+
+    // Loaded before the workers start; they only read it
+    try
+    {
+        AssetRegistry::setManifestPath(manifestPath);
+        AssetRegistry::getInstance();
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cerr << e.what() << "\n";
+        return 2;
+    }
+
+    std::vector<Result> results;
+    try
+    {
+        for (LevelFile& file : findLevelFiles(inputs))
+            results.push_back({ std::move(file.path), {} });
+    }
+    catch (const std::filesystem::filesystem_error& e)
+    {
+        std::cerr << "Couldn't list levels: " << e.what() << "\n";
+        return 2;
+    }
+
+    // Each worker takes the next file as it finishes one, so a few large levels don't hold up a chunk
+    const auto start = std::chrono::steady_clock::now();
+    WorkerPool pool;
+    std::atomic<size_t> next{ 0 };
+    pool.parallelFor(pool.size(), [&](size_t, size_t, unsigned)
+    {
+        for (size_t i = next++; i < results.size(); i = next++)
+            results[i].errors = validate(results[i].path);
+    });
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    size_t invalid = 0;
+    for (const Result& result : results)
+        invalid += !result.errors.empty();
+
+    if (reportPath.empty())
+        writeReport(std::cout, results, elapsed);
+    else
+    {
+        std::ofstream report(reportPath);
+        writeReport(report, results, elapsed);
+        if (!report)
+        {
+            std::cerr << "Couldn't write " << reportPath << "\n";
+            return 2;
+        }
+        std::cout << results.size() - invalid << " of " << results.size() << " levels valid, checked in "
+            << std::fixed << std::setprecision(1) << elapsed << " ms on " << pool.size() << " threads; report in " << reportPath << "\n";
+    }
+    return invalid ? 1 : 0;
+}
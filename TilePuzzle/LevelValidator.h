@@ -0,0 +1,40 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include <vector>
+#include "LevelData.h"
+
+/**
+ * @brief Offline tool: checks level files without SDL and reports every problem found in each.
+ * Run with `TilePuzzle --validate-levels <file or directory>... [--report report.json] [--manifest manifest.txt]`.
+ * Directories are searched recursively for level files; files are checked in parallel and the
+ * JSON report goes to the given file, or to stdout without --report. Keys resolve through the
+ * asset manifest, AssetRegistry::DEFAULT_MANIFEST unless --manifest names another.
+ */
+class LevelValidator
+{
+public:
+    struct Result
+    {
+        std::string path;
+        std::vector<std::string> errors;
+    };
+
+    /**
+     * @return every problem with the file, empty if it loads and every goal can be reached
+     */
+    [[nodiscard]] static std::vector<std::string> validate(const std::string& path);
+
+    /**
+     * @brief Checks object placement and goal reachability; the player starts on the first cell.
+     * Unknown keys and misplaced assets are reported while parsing; objects with unknown keys count as present.
+     */
+    static void validate(const LevelLayers& layers, std::vector<std::string>& errors);
+
+    static void writeReport(std::ostream& stream, const std::vector<Result>& results, double elapsedMilliseconds);
+
+    /**
+     * @return process exit code: 0 if every level is valid, 1 if any isn't, 2 for bad arguments
+     */
+    static int run(const std::vector<std::string>& arguments);
+};
@@ -0,0 +1,84 @@
+#include "LevelWatcher.h"
+#include <iostream>
+#include <system_error>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+
+LevelWatcher::LevelWatcher(const std::string& path) : m_path(std::filesystem::absolute(path))
+{
+    m_inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyDescriptor < 0)
+    {
+        std::cerr << "LevelWatcher: inotify unavailable, hot reload disabled\n";
+        return;
+    }
+
+    // Watch the directory so editors that save through rename are still seen
+    m_watchDescriptor = inotify_add_watch(m_inotifyDescriptor, m_path.parent_path().c_str(),
+        IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (m_watchDescriptor < 0)
+        std::cerr << "LevelWatcher: cannot watch " << m_path.parent_path() << "\n";
+}
+
+LevelWatcher::~LevelWatcher()
+{
+    if (m_inotifyDescriptor >= 0)
+        close(m_inotifyDescriptor);
+}
+
+bool LevelWatcher::poll()
+{
+    if (m_watchDescriptor < 0)
+        return false;
+
+    alignas(inotify_event) char buffer[4096];
+    const std::string fileName = m_path.filename().string();
+    bool changed = false;
+
+    ssize_t length;
+    while ((length = read(m_inotifyDescriptor, buffer, sizeof(buffer))) > 0)
+    {
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            if (event->len > 0 && fileName == event->name)
+                changed = true;
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+    return changed;
+}
+
+#else
+
+LevelWatcher::LevelWatcher(const std::string& path) : m_path(std::filesystem::absolute(path))
+{
+    std::error_code error;
+    m_lastWriteTime = std::filesystem::last_write_time(m_path, error);
+    m_lastPoll = std::chrono::steady_clock::now();
+}
+
+LevelWatcher::~LevelWatcher() = default;
+
+bool LevelWatcher::poll()
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastPoll < POLL_INTERVAL)
+        return false;
+    m_lastPoll = now;
+
+    std::error_code error;
+    const auto writeTime = std::filesystem::last_write_time(m_path, error);
+    if (error || writeTime == m_lastWriteTime)
+        return false;
+
+    m_lastWriteTime = writeTime;
+    return true;
+}
+
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+/**
+ * @brief Reports modifications of a level file without blocking the frame.
+ * Uses inotify on Linux and falls back to polling the write time elsewhere.
+ */
+class LevelWatcher
+{
+public:
+    explicit LevelWatcher(const std::string& path);
+    ~LevelWatcher();
+
+    LevelWatcher(const LevelWatcher&) = delete;
+    LevelWatcher& operator=(const LevelWatcher&) = delete;
+
+    /**
+     * @return true if the file changed since the last call
+     */
+    bool poll();
+
+private:
+    std::filesystem::path m_path;
+#ifdef __linux__
+    int m_inotifyDescriptor = -1;
+    int m_watchDescriptor = -1;
+#else
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{ 250 };
+    std::chrono::steady_clock::time_point m_lastPoll{};
+    std::filesystem::file_time_type m_lastWriteTime{};
+#endif
+};
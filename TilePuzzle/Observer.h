@@ -1,13 +1,64 @@
 #pragma once
+#include <cstddef>
+#include "GameEvents.h"
 
+/**
+ * @brief Base for anything that publishes or handles game events on a shared GameEventBus.
+ * Handlers are member functions taking a batch, e.g. void onLevelSolved(const LevelSolved*, size_t),
+ * registered with subscribe<LevelSolved, &Game::onLevelSolved>().
+ */
 class Observer
 {
 public:
     Observer() = default;
-    virtual ~Observer() = default;
+    explicit Observer(GameEventBus* eventBus) : m_eventBus(eventBus) {}
+    virtual ~Observer() { detachEventBus(); }
+
+    Observer(const Observer&) = delete;
+    Observer& operator=(const Observer&) = delete;
+
+    /**
+     * @return false if there is no bus or its ring is full
+     */
+    template <typename Event>
+    bool publish(const Event& event) const
+    {
+        return m_eventBus && m_eventBus->publish(event);
+    }
+
+    [[nodiscard]] GameEventBus* getEventBus() const { return m_eventBus; }
 
 protected:
-};
+    template <typename Event, auto Method>
+    void subscribe()
+    {
+        using Derived = typename MemberClass<decltype(Method)>::type;
+        m_eventBus->template subscribe<Event>(static_cast<Observer*>(this),
+            [](void* context, const Event* events, const size_t count)
+            {
+                (static_cast<Derived*>(static_cast<Observer*>(context))->*Method)(events, count);
+            });
+    }
+
+    /**
+     * @brief Drops this observer's handlers. Call it first if the bus is destroyed before the observer.
+     */
+    void detachEventBus()
+    {
+        if (m_eventBus)
+            m_eventBus->unsubscribe(static_cast<Observer*>(this));
+        m_eventBus = nullptr;
+    }
 
+private:
+    template <typename T>
+    struct MemberClass;
 
+    template <typename Class, typename Result, typename... Args>
+    struct MemberClass<Result (Class::*)(Args...)>
+    {
+        using type = Class;
+    };
 
+    GameEventBus* m_eventBus{};
+};
@@ -0,0 +1,333 @@
+#include "PathBenchmark.h"
+#include "JumpPointSearch.h"
+#include "SectorGraph.h"
+#include "CooperativePlanner.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <random>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint8_t OBSTACLE = BoardSnapshot::WallFlag | BoardSnapshot::BlockFlag;
+
+    BoardSnapshot makeBoard(std::mt19937& random, const int size, const double density)
+    {
+        BoardSnapshot board;
+        board.columns = size;
+        board.rows = size;
+        board.cells.resize(static_cast<size_t>(board.columns) * board.rows);
+
+        std::bernoulli_distribution isWall(density);
+        for (uint8_t& cell : board.cells)
+            cell = isWall(random) ? BoardSnapshot::WallFlag : 0;
+        return board;
+    }
+
+    int32_t randomFreeCell(std::mt19937& random, const BoardSnapshot& board)
+    {
+        std::uniform_int_distribution<int32_t> pick(0, static_cast<int32_t>(board.cells.size()) - 1);
+        int32_t cell;
+        do
+            cell = pick(random);
+        while (board.cells[cell] & OBSTACLE);
+        return cell;
+    }
+
+    // Every step moves to a free, 4-connected neighbour
+    bool isWalkable(const BoardSnapshot& board, const std::vector<int32_t>& path)
+    {
+        for (size_t i = 0; i < path.size(); ++i)
+        {
+            if (board.cells[path[i]] & OBSTACLE)
+                return false;
+            if (i > 0 && std::abs(path[i] % board.columns - path[i - 1] % board.columns)
+                + std::abs(path[i] / board.columns - path[i - 1] / board.columns) != 1)
+                return false;
+        }
+        return true;
+    }
+
+    double millisecondsSince(const Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    bool runBoard(const char* name, std::mt19937& random, const int size, const double density)
+    {
+        BoardSnapshot board = makeBoard(random, size, density);
+
+        JumpPointGrid grid;
+        Clock::time_point timer = Clock::now();
+        grid.rebuild(board);
+        const double rebuildTime = millisecondsSince(timer);
+
+        SectorGraph sectors;
+        timer = Clock::now();
+        sectors.rebuild(board);
+        const double sectorRebuildTime = millisecondsSince(timer);
+
+        double aStarTime = 0, jumpPointTime = 0, sectorTime = 0, firstSegmentTime = 0;
+        size_t aStarExpanded = 0, jumpPointExpanded = 0, sectorExpanded = 0, aStarLength = 0, sectorLength = 0;
+        int found = 0;
+        for (int i = 0; i < PathBenchmark::QUERIES; ++i)
+        {
+            const int32_t start = randomFreeCell(random, board);
+            const int32_t goal = randomFreeCell(random, board);
+
+            size_t expanded = 0;
+            timer = Clock::now();
+            const std::vector<int32_t> aStarPath = PathBenchmark::findPathAStar(board, start, goal, &expanded);
+            aStarTime += millisecondsSince(timer);
+            aStarExpanded += expanded;
+
+            timer = Clock::now();
+            const std::vector<int32_t> jumpPointPath = grid.findPath(start, goal);
+            jumpPointTime += millisecondsSince(timer);
+            jumpPointExpanded += JumpPointGrid::getLastExpandedCount();
+
+            if (aStarPath.size() != jumpPointPath.size() || !isWalkable(board, jumpPointPath))
+            {
+                std::cerr << name << ": JPS path disagrees with A* from " << start << " to " << goal << " ("
+                    << aStarPath.size() << " with A*, " << jumpPointPath.size() << " with JPS)\n";
+                return false;
+            }
+
+            // Latency until a walk can start, then the cost of refining everything up front
+            timer = Clock::now();
+            SectorRoute route = sectors.findRoute(start, goal);
+            if (route.waypoints.size() > 1)
+                static_cast<void>(sectors.refineNext(route));
+            firstSegmentTime += millisecondsSince(timer);
+            sectorExpanded += SectorGraph::getLastExpandedCount();
+
+            timer = Clock::now();
+            const std::vector<int32_t> sectorPath = sectors.findPath(start, goal);
+            sectorTime += millisecondsSince(timer);
+
+            if (aStarPath.empty() != sectorPath.empty() || sectorPath.size() < aStarPath.size() || !isWalkable(board, sectorPath))
+            {
+                std::cerr << name << ": HPA* path disagrees with A* from " << start << " to " << goal << " ("
+                    << aStarPath.size() << " with A*, " << sectorPath.size() << " with HPA*)\n";
+                return false;
+            }
+            aStarLength += aStarPath.size();
+            sectorLength += sectorPath.size();
+            found += !aStarPath.empty();
+        }
+
+        // Pushes as GameBoard::pushTile reports them: one cell freed, another obstructed
+        double patchTime = 0, sectorPatchTime = 0;
+        for (int i = 0; i < PathBenchmark::PUSHES; ++i)
+        {
+            const int32_t from = static_cast<int32_t>(random() % board.cells.size());
+            const int32_t to = randomFreeCell(random, board);
+            board.cells[from] = 0;
+            board.cells[to] = BoardSnapshot::BlockFlag;
+
+            timer = Clock::now();
+            grid.setBlocked(from, false);
+            grid.setBlocked(to, true);
+            patchTime += millisecondsSince(timer);
+
+            timer = Clock::now();
+            sectors.setBlocked(from, false);
+            sectors.setBlocked(to, true);
+            sectorPatchTime += millisecondsSince(timer);
+        }
+
+        JumpPointGrid rebuilt;
+        rebuilt.rebuild(board);
+        for (int32_t cell = 0; cell < static_cast<int32_t>(board.cells.size()); ++cell)
+        {
+            for (int direction = 0; direction < JumpPointGrid::DIRECTION_COUNT; ++direction)
+            {
+                const auto d = static_cast<JumpPointGrid::Direction>(direction);
+                if (grid.getJumpDistance(cell, d) != rebuilt.getJumpDistance(cell, d))
+                {
+                    std::cerr << name << ": patched jump distance differs from a rebuild at cell " << cell << "\n";
+                    return false;
+                }
+            }
+        }
+
+        SectorGraph rebuiltSectors;
+        rebuiltSectors.rebuild(board);
+        for (int i = 0; i < PathBenchmark::QUERIES; ++i)
+        {
+            const int32_t start = randomFreeCell(random, board);
+            const int32_t goal = randomFreeCell(random, board);
+            if (sectors.findRoute(start, goal).waypoints != rebuiltSectors.findRoute(start, goal).waypoints)
+            {
+                std::cerr << name << ": patched sectors route differently from a rebuild from " << start << " to " << goal << "\n";
+                return false;
+            }
+        }
+
+        std::cout << std::fixed << std::setprecision(3)
+            << name << " (" << size << "x" << size << ", "
+            << static_cast<int>(density * 100) << "% walls, " << found << "/" << PathBenchmark::QUERIES << " reachable)\n"
+            << "  A*:  " << aStarTime / PathBenchmark::QUERIES << " ms/query, "
+            << aStarExpanded / PathBenchmark::QUERIES << " nodes expanded\n"
+            << "  JPS: " << jumpPointTime / PathBenchmark::QUERIES << " ms/query, "
+            << jumpPointExpanded / PathBenchmark::QUERIES << " nodes expanded\n"
+            << "  HPA*: " << sectorTime / PathBenchmark::QUERIES << " ms/query, "
+            << firstSegmentTime / PathBenchmark::QUERIES << " ms to the first segment, "
+            << sectorExpanded / PathBenchmark::QUERIES << " abstract nodes expanded, "
+            << std::setprecision(1) << (aStarLength ? 100.0 * sectorLength / aStarLength - 100 : 0.0) << "% longer\n"
+            << std::setprecision(3)
+            << "  jump distances: " << rebuildTime << " ms to build, "
+            << patchTime / PathBenchmark::PUSHES << " ms to patch a push\n"
+            << "  sectors: " << sectors.getEntranceCount() << " entrances, " << sectorRebuildTime << " ms to build, "
+            << sectorPatchTime / PathBenchmark::PUSHES << " ms to patch a push\n";
+        return true;
+    }
+
+    bool runMovers(std::mt19937& random)
+    {
+        const BoardSnapshot board = makeBoard(random, PathBenchmark::MOVER_BOARD_SIZE, PathBenchmark::SPARSE_DENSITY);
+        CooperativePlanner planner;
+        planner.rebuild(board);
+
+        std::vector<uint8_t> taken(board.cells.size());
+        for (int i = 0; i < PathBenchmark::MOVERS; ++i)
+        {
+            int32_t cell;
+            do
+                cell = randomFreeCell(random, board);
+            while (taken[cell]);
+            taken[cell] = 1;
+            static_cast<void>(planner.addAgent(cell, randomFreeCell(random, board)));
+        }
+
+        double planTime = 0, worstPlanTime = 0;
+        size_t expansions = 0;
+        int steps = 0, arrived = 0;
+        std::vector<int32_t> previous(PathBenchmark::MOVERS);
+        std::vector<int32_t> occupant(board.cells.size(), -1);
+        for (; steps < PathBenchmark::MOVER_STEPS && arrived < PathBenchmark::MOVERS; ++steps)
+        {
+            for (int agent = 0; agent < PathBenchmark::MOVERS; ++agent)
+                previous[agent] = planner.getCell(agent);
+
+            const Clock::time_point timer = Clock::now();
+            planner.plan();
+            const double elapsed = millisecondsSince(timer);
+            planTime += elapsed;
+            worstPlanTime = std::max(worstPlanTime, elapsed);
+            expansions += planner.getLastExpansions();
+            static_cast<void>(planner.advance());
+
+            arrived = 0;
+            std::fill(occupant.begin(), occupant.end(), -1);
+            for (int agent = 0; agent < PathBenchmark::MOVERS; ++agent)
+            {
+                const int32_t cell = planner.getCell(agent);
+                const int32_t from = previous[agent];
+                const bool adjacent = std::abs(cell % board.columns - from % board.columns)
+                    + std::abs(cell / board.columns - from / board.columns) <= 1;
+                if (occupant[cell] >= 0 || !adjacent || (board.cells[cell] & OBSTACLE) ||
+                    (cell != from && occupant[from] >= 0 && previous[occupant[from]] == cell))
+                {
+                    std::cerr << "Movers: conflict at cell " << cell << " on step " << steps << "\n";
+                    return false;
+                }
+                occupant[cell] = agent;
+                arrived += cell == planner.getGoal(agent);
+            }
+
+            // Swaps where the second mover of the pair was checked first
+            for (int agent = 0; agent < PathBenchmark::MOVERS; ++agent)
+            {
+                const int32_t other = occupant[previous[agent]];
+                if (other >= 0 && other != agent && previous[other] == planner.getCell(agent))
+                {
+                    std::cerr << "Movers: swap between " << agent << " and " << other << " on step " << steps << "\n";
+                    return false;
+                }
+            }
+        }
+
+        std::cout << std::fixed << std::setprecision(3)
+            << "Movers (" << PathBenchmark::MOVER_BOARD_SIZE << "x" << PathBenchmark::MOVER_BOARD_SIZE << ", "
+            << PathBenchmark::MOVERS << " agents, budget " << planner.getBudget() << " expansions)\n"
+            << "  " << arrived << " at their goal after " << steps << " steps, no conflicts\n"
+            << "  planning: " << planTime / steps << " ms/step average, " << worstPlanTime << " ms worst, "
+            << expansions / steps << " expansions/step\n";
+        return true;
+    }
+}
+
+std::vector<int32_t> PathBenchmark::findPathAStar(const BoardSnapshot& board, const int32_t start, const int32_t goal, size_t* expanded)
+{
+    if (expanded)
+        *expanded = 0;
+    if (board.cells[goal] & OBSTACLE)
+        return {};
+
+    auto heuristic = [&](const int32_t cell)
+    {
+        return std::abs(cell % board.columns - goal % board.columns) + std::abs(cell / board.columns - goal / board.columns);
+    };
+
+    using Entry = std::pair<int, int32_t>;   // f, cell
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> openList;
+    std::vector<int> gScores(board.cells.size(), std::numeric_limits<int>::max());
+    std::vector<int32_t> parents(board.cells.size(), -1);
+    std::vector<uint8_t> closed(board.cells.size());
+
+    gScores[start] = 0;
+    openList.push({ heuristic(start), start });
+    while (!openList.empty())
+    {
+        const int32_t current = openList.top().second;
+        openList.pop();
+        if (closed[current])
+            continue;
+        closed[current] = 1;
+        if (expanded)
+            ++*expanded;
+
+        if (current == goal)
+        {
+            std::vector<int32_t> path;
+            for (int32_t cell = goal; cell >= 0; cell = parents[cell])
+                path.push_back(cell);
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+
+        for (int direction = 0; direction < 4; ++direction)
+        {
+            const int32_t next = board.neighbor(current, direction);
+            if (next < 0 || closed[next] || (board.cells[next] & OBSTACLE))
+                continue;
+
+            const int g = gScores[current] + 1;
+            if (g < gScores[next])
+            {
+                gScores[next] = g;
+                parents[next] = current;
+                openList.push({ g + heuristic(next), next });
+            }
+        }
+    }
+    return {};
+}
+
+int PathBenchmark::run(const uint32_t seed)
+{
+    std::mt19937 random(seed);
+    const bool passed = runBoard("Sparse", random, BOARD_SIZE, SPARSE_DENSITY) &&
+        runBoard("Dense", random, BOARD_SIZE, DENSE_DENSITY) &&
+        runBoard("Large sparse", random, LARGE_BOARD_SIZE, SPARSE_DENSITY) &&
+        runMovers(random);
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BoardSnapshot.h"
+
+/**
+ * @brief Offline tool: compares Jump Point Search and HPA* with plain A* on random sparse and dense boards,
+ * then walks a crowd of cooperative movers and checks that no two ever share or swap cells.
+ * Run with `TilePuzzle --benchmark-paths [seed]`. Fails if they disagree on a path or if the
+ * incrementally patched structures drift from a full rebuild.
+ */
+class PathBenchmark
+{
+public:
+    static constexpr int BOARD_SIZE = 256;
+    static constexpr int LARGE_BOARD_SIZE = 1024;                // Beyond what levels load today, where HPA* pays off
+    static constexpr int QUERIES = 200;
+    static constexpr int PUSHES = 200;
+    static constexpr double SPARSE_DENSITY = 0.1;
+    static constexpr double DENSE_DENSITY = 0.35;
+    static constexpr int MOVER_BOARD_SIZE = 128;
+    static constexpr int MOVERS = 300;
+    static constexpr int MOVER_STEPS = 600;
+
+    /**
+     * @brief A* over cell indices with the same cost and heuristic as GameBoard's, without the tiles.
+     * @return every cell from start to goal inclusive, empty if unreachable
+     */
+    static std::vector<int32_t> findPathAStar(const BoardSnapshot& board, int32_t start, int32_t goal, size_t* expanded = nullptr);
+
+    /**
+     * @return process exit code
+     */
+    static int run(uint32_t seed);
+};
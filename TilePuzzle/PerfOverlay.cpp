@@ -0,0 +1,193 @@
+#include "PerfOverlay.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+    constexpr int MARGIN = 8;
+    constexpr int PADDING = 6;
+    constexpr int GLYPH_COLUMNS = 3;
+    constexpr int GLYPH_ROWS = 5;
+    constexpr int LINE_HEIGHT = (GLYPH_ROWS + 2) * PerfOverlay::GLYPH_SCALE;
+    constexpr int ADVANCE = (GLYPH_COLUMNS + 1) * PerfOverlay::GLYPH_SCALE;
+    constexpr int LINE_COUNT = 6;
+    constexpr size_t MAX_TEXT_RECTS = 2048;
+
+    constexpr SDL_Color COLORS[] = {
+        { 0, 0, 0, 170 },        // Panel
+        { 80, 160, 255, 255 },   // Input
+        { 255, 200, 60, 255 },   // Update
+        { 90, 220, 110, 255 },   // Render
+        { 110, 110, 110, 255 },  // Other
+        { 255, 70, 70, 255 },    // Budget
+        { 235, 235, 235, 255 },  // Text
+    };
+
+    /**
+     * @return 3x5 glyph, one bit per pixel from the top left, three bits per row; 0 for blanks
+     */
+    constexpr uint16_t getGlyph(const char character)
+    {
+        switch (character)
+        {
+        case '0': case 'O': return 0b111'101'101'101'111;
+        case '1': return 0b010'110'010'010'111;
+        case '2': return 0b111'001'111'100'111;
+        case '3': return 0b111'001'111'001'111;
+        case '4': return 0b101'101'111'001'001;
+        case '5': return 0b111'100'111'001'111;
+        case '6': return 0b111'100'111'101'111;
+        case '7': return 0b111'001'001'001'001;
+        case '8': return 0b111'101'111'101'111;
+        case '9': return 0b111'101'111'001'111;
+        case '.': return 0b000'000'000'000'010;
+        case '/': return 0b001'001'010'100'100;
+        case 'A': return 0b010'101'111'101'101;
+        case 'B': return 0b110'101'110'101'110;
+        case 'C': return 0b011'100'100'100'011;
+        case 'D': return 0b110'101'101'101'110;
+        case 'E': return 0b111'100'110'100'111;
+        case 'F': return 0b111'100'110'100'100;
+        case 'G': return 0b011'100'101'101'011;
+        case 'H': return 0b101'101'111'101'101;
+        case 'I': return 0b111'010'010'010'111;
+        case 'K': return 0b101'101'110'101'101;
+        case 'L': return 0b100'100'100'100'111;
+        case 'M': return 0b101'111'111'101'101;
+        case 'N': return 0b110'101'101'101'101;
+        case 'P': return 0b110'101'110'100'100;
+        case 'R': return 0b110'101'110'101'101;
+        case 'S': return 0b011'100'010'001'110;
+        case 'T': return 0b111'010'010'010'010;
+        case 'U': return 0b101'101'101'101'111;
+        case 'W': return 0b101'101'111'111'101;
+        case 'X': return 0b101'101'010'101'101;
+        default: return 0;
+        }
+    }
+}
+
+PerfOverlay::PerfOverlay()
+{
+    for (auto& rects : m_rects)
+        rects.reserve(HISTORY);
+    m_rects[Text].reserve(MAX_TEXT_RECTS);
+}
+
+void PerfOverlay::record(const Sample& sample)
+{
+    m_samples[m_next] = sample;
+    m_next = (m_next + 1) % HISTORY;
+}
+
+int PerfOverlay::drawText(int x, const int y, const char* text, const Batch batch)
+{
+    std::vector<SDL_Rect>& rects = m_rects[batch];
+    for (; *text; ++text, x += ADVANCE)
+    {
+        const uint16_t glyph = getGlyph(*text);
+        for (int row = 0; row < GLYPH_ROWS; ++row)
+        {
+            // One rectangle per run of lit pixels in the row
+            const int bits = glyph >> ((GLYPH_ROWS - 1 - row) * GLYPH_COLUMNS) & 0b111;
+            for (int column = 0; column < GLYPH_COLUMNS; ++column)
+            {
+                if (!(bits & (0b100 >> column)))
+                    continue;
+
+                int length = 1;
+                while (column + length < GLYPH_COLUMNS && bits & (0b100 >> (column + length)))
+                    ++length;
+                if (rects.size() < MAX_TEXT_RECTS)
+                    rects.push_back({ x + column * GLYPH_SCALE, y + row * GLYPH_SCALE, length * GLYPH_SCALE, GLYPH_SCALE });
+                column += length;
+            }
+        }
+    }
+    return x;
+}
+
+void PerfOverlay::render(SDL_Renderer* renderer)
+{
+    if (!m_visible)
+        return;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (auto& rects : m_rects)
+        rects.clear();
+
+    const int left = MARGIN + PADDING;
+    const int width = static_cast<int>(HISTORY) * BAR_WIDTH;
+    const int graphTop = MARGIN + PADDING + LINE_COUNT * LINE_HEIGHT;
+    const int graphBottom = graphTop + GRAPH_HEIGHT;
+    m_rects[Panel].push_back({ MARGIN, MARGIN, width + 2 * PADDING, graphBottom + PADDING - MARGIN });
+
+    // Oldest to newest, each bar stacked input, update, render, then whatever is left of the frame
+    const double scale = GRAPH_HEIGHT / GRAPH_RANGE;
+    for (size_t i = 0; i < HISTORY; ++i)
+    {
+        const Sample& sample = m_samples[(m_next + i) % HISTORY];
+        const int x = left + static_cast<int>(i) * BAR_WIDTH;
+        int y = graphBottom;
+        const double other = sample.frameTime - sample.inputTime - sample.updateTime - sample.renderTime;
+        const std::pair<Batch, double> segments[] = {
+            { Input, sample.inputTime }, { Update, sample.updateTime }, { Render, sample.renderTime }, { Other, other }
+        };
+        for (const auto& [batch, time] : segments)
+        {
+            const int height = std::min(y - graphTop, static_cast<int>(std::max(0.0, time) * scale + 0.5));
+            if (height <= 0)
+                continue;
+            y -= height;
+            m_rects[batch].push_back({ x, y, BAR_WIDTH, height });
+        }
+    }
+    m_rects[Budget].push_back({ left, graphBottom - static_cast<int>(FRAME_BUDGET * scale + 0.5), width, 1 });
+
+    const Sample& latest = m_samples[(m_next + HISTORY - 1) % HISTORY];
+    char line[64];
+    int y = MARGIN + PADDING;
+    std::snprintf(line, sizeof(line), "FPS %u  FRAME %.2f MS", latest.fps, latest.frameTime);
+    drawText(left, y, line, Text);
+
+    y += LINE_HEIGHT;
+    std::snprintf(line, sizeof(line), "IN %.2f ", latest.inputTime);
+    int x = drawText(left, y, line, Input);
+    std::snprintf(line, sizeof(line), "UPD %.2f ", latest.updateTime);
+    x = drawText(x, y, line, Update);
+    std::snprintf(line, sizeof(line), "RND %.2f", latest.renderTime);
+    drawText(x, y, line, Render);
+
+    y += LINE_HEIGHT;
+    std::snprintf(line, sizeof(line), "DRAW %u  TEX SW %u", latest.drawCalls, latest.textureSwitches);
+    drawText(left, y, line, Text);
+
+    y += LINE_HEIGHT;
+    std::snprintf(line, sizeof(line), "TEXTURES %zu KIB", latest.residentBytes / 1024);
+    drawText(left, y, line, Text);
+
+    y += LINE_HEIGHT;
+    std::snprintf(line, sizeof(line), "PATH %.2f MS  HUD %.3f MS", latest.pathQueryTime, m_cost);
+    drawText(left, y, line, Text);
+
+    y += LINE_HEIGHT;
+    std::snprintf(line, sizeof(line), "GOALS %d/%d  PUSHES %u%s", latest.filledGoals, latest.goalCount, latest.pushes,
+        latest.solved ? "  DONE" : "");
+    drawText(left, y, line, latest.solved ? Render : Text);
+
+    // One fill per colour; the draw colour is the renderer's clear colour too, so it is put back
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    for (int batch = 0; batch < BatchCount; ++batch)
+    {
+        if (m_rects[batch].empty())
+            continue;
+        SDL_SetRenderDrawColor(renderer, COLORS[batch].r, COLORS[batch].g, COLORS[batch].b, COLORS[batch].a);
+        SDL_RenderFillRects(renderer, m_rects[batch].data(), static_cast<int>(m_rects[batch].size()));
+    }
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    m_cost = elapsed.count();
+}
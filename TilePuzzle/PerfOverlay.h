@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <SDL.h>
+
+/**
+ * @brief In-window performance readout, drawn with filled rectangles only (no fonts, no textures).
+ * Shows a rolling graph of frame times split into input, update and render, and the latest frame's
+ * FPS, draw calls, texture switches, resident texture bytes, pathfinding query time and the level's progress.
+ * Rectangles are batched per colour into buffers reserved up front, so drawing never allocates.
+ */
+class PerfOverlay
+{
+public:
+    struct Sample
+    {
+        double frameTime{};         // Milliseconds, like every time below
+        double inputTime{};
+        double updateTime{};
+        double renderTime{};
+        double pathQueryTime{};
+        uint32_t fps{};
+        uint32_t drawCalls{};
+        uint32_t textureSwitches{};
+        size_t residentBytes{};
+        int filledGoals{};
+        int goalCount{};
+        uint32_t pushes{};          // Since the level was loaded
+        bool solved{};
+    };
+
+    static constexpr size_t HISTORY = 120;                 // Frames in the graph, one bar each
+    static constexpr int BAR_WIDTH = 2;
+    static constexpr int GRAPH_HEIGHT = 64;
+    static constexpr double GRAPH_RANGE = 33.3;            // Milliseconds at the top of the graph
+    static constexpr double FRAME_BUDGET = 1000.0 / 60.0;  // Drawn as a line across the graph
+    static constexpr int GLYPH_SCALE = 2;                  // Screen pixels per font pixel
+
+    PerfOverlay();
+
+    void toggle() { m_visible = !m_visible; }
+    [[nodiscard]] bool isVisible() const { return m_visible; }
+
+    /**
+     * @brief Adds a finished frame; kept while hidden so the graph is full when shown.
+     */
+    void record(const Sample& sample);
+
+    /**
+     * @brief Draws in window coordinates on top of everything; call before presenting.
+     */
+    void render(SDL_Renderer* renderer);
+
+    /**
+     * @return milliseconds the last render() took on the CPU
+     */
+    [[nodiscard]] double getCost() const { return m_cost; }
+
+private:
+    enum Batch
+    {
+        Panel = 0,
+        Input,
+        Update,
+        Render,
+        Other,                      // Frame time not spent in the three above, e.g. waiting
+        Budget,
+        Text,
+        BatchCount
+    };
+
+    /**
+     * @return x just past the last glyph
+     */
+    int drawText(int x, int y, const char* text, Batch batch);
+
+    std::array<Sample, HISTORY> m_samples{};
+    size_t m_next{};                                       // Oldest sample, overwritten next
+    std::array<std::vector<SDL_Rect>, BatchCount> m_rects;
+    double m_cost{};
+    bool m_visible{};
+};
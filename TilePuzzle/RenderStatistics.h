@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <SDL.h>
+
+struct DrawStatistics
+{
+    uint32_t drawCalls{};
+    uint32_t textureSwitches{};
+};
+
+/**
+ * @brief Texture copies issued this frame and how often the source texture changed between them.
+ * Every SDL_RenderCopy goes through copy(); a switch breaks the renderer's batching.
+ */
+class RenderStatistics
+{
+public:
+    static void beginFrame()
+    {
+        s_frame = {};
+        s_lastTexture = nullptr;
+    }
+
+    static int copy(SDL_Renderer* renderer, SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect* destination)
+    {
+        ++s_frame.drawCalls;
+        if (texture != s_lastTexture)
+        {
+            ++s_frame.textureSwitches;
+            s_lastTexture = texture;
+        }
+        return SDL_RenderCopy(renderer, texture, source, destination);
+    }
+
+    [[nodiscard]] static const DrawStatistics& getFrame() { return s_frame; }
+
+private:
+    static inline DrawStatistics s_frame{};
+    static inline const SDL_Texture* s_lastTexture{};
+};
@@ -1,5 +1,7 @@
 ﻿#include "Renderer.h"
 #include "GameBoard.h"
+#include "RenderStatistics.h"
+#include <algorithm>
 
 Renderer::Renderer(
     SDL_Window* window,
@@ -14,28 +16,47 @@ Renderer::Renderer(
     m_renderer = std::unique_ptr<SDL_Renderer, RendererDeleter>(renderer);
 }
 
-Renderer::~Renderer()
+void Renderer::renderAll(const std::vector<std::shared_ptr<Entity>>& entities) const
 {
-    if (m_renderingThread.joinable())
+    const SDL_Rect visibleRect = m_camera->getVisibleRect();
+    for (const auto& entity : entities)
     {
-        m_renderingThread.join();
+        render(*entity, visibleRect);
     }
 }
 
-void Renderer::renderAll(const std::vector<std::shared_ptr<Entity>>& entities) const
+void Renderer::renderObjects(const GameBoard& board) const
 {
-    for (const auto& entity : entities)
+    const DynamicBoard& tiles = board.getTileGrid();
+    const SDL_Rect visibleRect = m_camera->getVisibleRect();
+
+    // One tile of margin for sprites overhanging their tile
+    const Vector2<int> first = TileGeometry::toBoardCoordinates({ visibleRect.x, visibleRect.y });
+    const Vector2<int> last = TileGeometry::toBoardCoordinates({ visibleRect.x + visibleRect.w, visibleRect.y + visibleRect.h });
+    for (int y = std::max(0, first.y - 1); y <= std::min(tiles.rows() - 1, last.y + 1); ++y)
     {
-        render(entity);
+        for (int x = std::max(0, first.x - 1); x <= std::min(tiles.columns() - 1, last.x + 1); ++x)
+        {
+            // A moving object may be far from the tile it will come to rest on
+            const std::shared_ptr<Sprite> resident = tiles.at(x, y)->getResidingEntity();
+            if (resident && !resident->isMoving())
+                render(*resident, visibleRect);
+        }
     }
+
+    for (const auto& object : board.getMovingObjects())
+        render(*object, visibleRect);
 }
 
-void Renderer::render(const std::shared_ptr<Entity>& entity) const
+void Renderer::render(const Entity& entity, const SDL_Rect& visibleRect) const
 {
-    if (!entity->getRenderFlag())
+    if (!entity.getRenderFlag())
         return;
 
-    SDL_Rect entityRect = entity->getSdlRect();
-    SDL_RenderCopy(m_renderer.get(), entity->getCachedTexture(), nullptr, &entityRect);
-}
+    const SDL_Rect worldRect = entity.getRenderRect(m_interpolation);
+    if (SDL_HasIntersection(&visibleRect, &worldRect) != SDL_TRUE)
+        return;
 
+    const SDL_Rect entityRect = m_camera->worldToScreen(worldRect);
+    RenderStatistics::copy(m_renderer.get(), entity.getCachedTexture(), entity.getSourceRect(), &entityRect);
+}
@@ -1,11 +1,12 @@
 ﻿#pragma once
 
 #include <SDL.h>
-#include <future>
 #include <memory>
-#include <thread>
 #include <vector>
+#include "Camera.h"
 #include "GameBoard.h"
+#include "PerfOverlay.h"
+#include "TileChunkLayer.h"
 
 struct RendererDeleter
 {
@@ -16,25 +17,56 @@ class Renderer
 {
 public:
     Renderer(SDL_Window* window, int rendererIndex, uint32_t rendererFlags);
-    ~Renderer();
 
     SDL_Renderer* getRenderer() const { return m_renderer.get(); }
 
     template<typename... Args>
     void renderInLayers(std::vector<std::shared_ptr<Entity>>& first, Args&&... args) const
     {
-        std::thread t(&Renderer::renderAll, this, std::cref(first));
-        t.join();
+        renderAll(first);
+        renderInLayers(std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void renderInLayers(TileChunkLayer& first, Args&&... args) const
+    {
+        first.render(*m_camera);
+        renderInLayers(std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void renderInLayers(const GameBoard& first, Args&&... args) const
+    {
+        renderObjects(first);
+        renderInLayers(std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void renderInLayers(PerfOverlay& first, Args&&... args) const
+    {
+        first.render(m_renderer.get());
         renderInLayers(std::forward<Args>(args)...);
     }
 
     void renderInLayers() const { SDL_RenderPresent(m_renderer.get());}
 
     void clear() const { SDL_RenderClear(m_renderer.get()); }
+
+    // Fraction of a simulation step to interpolate moving entities by
+    void setInterpolation(const double interpolation) { m_interpolation = interpolation; }
+
+    // Entities are positioned in world space and drawn through the camera; must be set before rendering
+    void setCamera(const Camera* camera) { m_camera = camera; }
 private:
     void renderAll(const std::vector<std::shared_ptr<Entity>>& entities) const;
-    void render(const std::shared_ptr<Entity>& entity) const;
+
+    /**
+     * @brief Draws the objects resting on visible tiles, found through the tile grid, then the moving ones.
+     */
+    void renderObjects(const GameBoard& board) const;
+    void render(const Entity& entity, const SDL_Rect& visibleRect) const;
     std::unique_ptr<SDL_Renderer, RendererDeleter> m_renderer;
-    std::thread m_renderingThread{};
+    double m_interpolation{};
+    const Camera* m_camera{};
 
 };
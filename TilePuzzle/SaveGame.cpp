@@ -0,0 +1,358 @@
+#include "SaveGame.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+namespace
+{
+    constexpr size_t alignSection(const size_t offset) { return (offset + 7) & ~size_t{ 7 }; }
+
+    template <typename T>
+    void writeArray(std::ofstream& file, const std::vector<T>& values)
+    {
+        file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+
+    void pad(std::ofstream& file, const size_t written)
+    {
+        static constexpr char zeros[8]{};
+        file.write(zeros, static_cast<std::streamsize>(alignSection(written) - written));
+    }
+}
+
+SaveFile::Layout SaveFile::getLayout(const SaveHeader& header)
+{
+    Layout layout{};
+    layout.levelPath = sizeof(SaveHeader);
+    layout.cells = alignSection(layout.levelPath + header.levelPathLength);
+    layout.objects = alignSection(layout.cells + static_cast<size_t>(header.columns) * header.rows);
+    layout.checkpoints = layout.objects + header.objectCount * sizeof(SaveObject);
+    layout.waypoints = layout.checkpoints + header.playerCheckpointCount * sizeof(SaveCheckpoint);
+    layout.end = layout.waypoints + header.routeWaypointCount * sizeof(int32_t);
+    return layout;
+}
+
+SaveFile::SaveFile(const std::string& path)
+    : m_file(path)
+{
+    if (m_file.size() < sizeof(SaveHeader) || std::memcmp(getHeader().magic, "TPSV", 4) != 0)
+        throw std::runtime_error(path + " is not a save file");
+
+    const SaveHeader& header = getHeader();
+    if (header.version != FORMAT_VERSION)
+        throw std::runtime_error(path + " has save version " + std::to_string(header.version) +
+            ", expected " + std::to_string(FORMAT_VERSION));
+    if (header.columns < 0 || header.rows < 0 || header.routeNextSegment > header.routeWaypointCount)
+        throw std::runtime_error(path + " is corrupt");
+
+    const Layout layout = getLayout(header);
+    if (m_file.size() < layout.end)
+        throw std::runtime_error(path + " is truncated");
+
+    m_cellsOffset = layout.cells;
+    m_objectsOffset = layout.objects;
+    m_checkpointsOffset = layout.checkpoints;
+    m_waypointsOffset = layout.waypoints;
+}
+
+std::string_view SaveFile::getLevelPath() const
+{
+    return { at<char>(sizeof(SaveHeader)), getHeader().levelPathLength };
+}
+
+void SaveRecords::reset(const size_t cellCount)
+{
+    m_pages = std::make_shared<Pages>();
+    m_size = 0;
+    m_recordByCell.assign(cellCount, -1);
+    m_sliding.clear();
+}
+
+void SaveRecords::add(const SaveObject& record)
+{
+    const int32_t index = static_cast<int32_t>(m_size);
+    if (m_size % PAGE_SIZE == 0)
+    {
+        auto page = std::make_shared<Page>();
+        page->reserve(PAGE_SIZE);
+        editPages().push_back(std::move(page));
+    }
+    editPage(m_size / PAGE_SIZE).push_back(record);
+    ++m_size;
+
+    m_recordByCell[record.cell] = index;
+    if (record.hasCheckpoint)
+        m_sliding.push_back(index);
+}
+
+void SaveRecords::remove(const int32_t cell)
+{
+    const int32_t index = m_recordByCell[cell];
+    if (index < 0)
+        return;
+
+    m_recordByCell[cell] = -1;
+    std::erase(m_sliding, index);
+
+    // Filling the gap with the last record keeps every page full but the last
+    const auto last = static_cast<int32_t>(m_size - 1);
+    if (index != last)
+    {
+        const SaveObject moved = (*(*m_pages)[last / PAGE_SIZE])[last % PAGE_SIZE];
+        edit(index) = moved;
+        m_recordByCell[moved.cell] = index;
+        std::replace(m_sliding.begin(), m_sliding.end(), last, index);
+    }
+
+    Page& page = editPage(last / PAGE_SIZE);
+    page.pop_back();
+    if (page.empty())
+        editPages().pop_back();
+    --m_size;
+}
+
+void SaveRecords::push(const int32_t fromCell, const int32_t toCell, const int32_t checkpointX, const int32_t checkpointY,
+    const uint8_t state)
+{
+    const int32_t index = m_recordByCell[fromCell];
+    if (index < 0)
+        return;
+
+    m_recordByCell[fromCell] = -1;
+    m_recordByCell[toCell] = index;
+    SaveObject& record = edit(index);
+    if (!record.hasCheckpoint)
+        m_sliding.push_back(index);
+    record.cell = toCell;
+    record.hasCheckpoint = 1;
+    record.checkpointX = checkpointX;
+    record.checkpointY = checkpointY;
+    record.state = state;
+}
+
+SaveObject& SaveRecords::edit(const int32_t index)
+{
+    return editPage(index / PAGE_SIZE)[index % PAGE_SIZE];
+}
+
+SaveRecords::Pages& SaveRecords::editPages()
+{
+    // Copy on write: the writer may still be serializing the shared table. While the table is
+    // shared every page is too, so copying it leaves pages shared until they are edited.
+    if (m_pages.use_count() > 1)
+        m_pages = std::make_shared<Pages>(*m_pages);
+    return *m_pages;
+}
+
+SaveRecords::Page& SaveRecords::editPage(const size_t page)
+{
+    std::shared_ptr<Page>& target = editPages()[page];
+    if (target.use_count() > 1)
+        target = std::make_shared<Page>(*target);
+    return *target;
+}
+
+SaveWriter::SaveWriter()
+{
+    m_thread = std::thread(&SaveWriter::workerLoop, this);
+}
+
+SaveWriter::~SaveWriter()
+{
+    flush();
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void SaveWriter::submit(SaveState state, std::string path)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_pending.emplace(std::move(state), std::move(path));
+    }
+    m_wake.notify_one();
+}
+
+void SaveWriter::flush()
+{
+    std::unique_lock lock(m_mutex);
+    m_idle.wait(lock, [this] { return !m_pending && !m_writing; });
+}
+
+void SaveWriter::write(const SaveState& state, const std::string& path)
+{
+    const BoardSnapshot& board = *state.board;
+
+    SaveHeader header{};
+    std::memcpy(header.magic, "TPSV", 4);
+    header.version = SaveFile::FORMAT_VERSION;
+    header.columns = board.columns;
+    header.rows = board.rows;
+    header.layoutHash = state.layoutHash;
+    header.occupancyHash = state.occupancyHash;
+    header.levelPathLength = static_cast<uint32_t>(state.levelPath.size());
+    header.objectCount = static_cast<uint32_t>(state.objectCount);
+    header.playerCheckpointCount = static_cast<uint32_t>(state.playerCheckpoints.size());
+    header.routeWaypointCount = static_cast<uint32_t>(state.routeWaypoints.size());
+    header.routeNextSegment = state.routeNextSegment;
+    header.playerCell = board.playerCell;
+    header.playerX = state.playerX;
+    header.playerY = state.playerY;
+
+    // Write under a temporary name so a crash never leaves a truncated save behind
+    const std::filesystem::path target(path);
+    if (target.has_parent_path())
+        std::filesystem::create_directories(target.parent_path());
+    const std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(state.levelPath.data(), static_cast<std::streamsize>(state.levelPath.size()));
+        pad(file, sizeof(header) + state.levelPath.size());
+        writeArray(file, board.cells);
+        pad(file, board.cells.size());
+        for (const auto& page : *state.objects)
+            writeArray(file, *page);
+        writeArray(file, state.playerCheckpoints);
+        writeArray(file, state.routeWaypoints);
+        if (!file)
+            throw std::runtime_error("Couldn't write " + temporaryPath);
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error)
+        throw std::runtime_error("Couldn't write " + path + ": " + error.message());
+}
+
+void SaveWriter::workerLoop()
+{
+    while (true)
+    {
+        std::pair<SaveState, std::string> job;
+        {
+            std::unique_lock lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || m_pending; });
+            if (m_stopping)
+                return;
+            job = std::move(*m_pending);
+            m_pending.reset();
+            m_writing = true;
+        }
+
+        try
+        {
+            write(job.first, job.second);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Save failed: " << e.what() << "\n";
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_writing = false;
+        }
+        m_idle.notify_all();
+    }
+}
+
+int SaveWriter::runBenchmark(const std::string& directory)
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr int size = 1024;
+    constexpr double density = 0.1;
+    constexpr int saves = 20;
+
+    try
+    {
+        // Stand-ins for the board's objects, one per obstructed cell, recorded as GameBoard does on load
+        std::mt19937 random(1);
+        std::bernoulli_distribution isObject(density);
+        auto board = std::make_shared<BoardSnapshot>();
+        board->columns = size;
+        board->rows = size;
+        board->cells.resize(static_cast<size_t>(size) * size);
+        SaveRecords records;
+        records.reset(board->cells.size());
+        for (int32_t cell = 0; cell < static_cast<int32_t>(board->cells.size()); ++cell)
+        {
+            if (isObject(random))
+            {
+                board->cells[cell] = BoardSnapshot::BlockFlag;
+                SaveObject object{};
+                object.x = cell % size * 86.0;
+                object.y = cell / size * 64.0;
+                object.spawnCell = cell;
+                object.cell = cell;
+                records.add(object);
+            }
+        }
+
+        SaveWriter writer;
+        const std::string path = (std::filesystem::path(directory) / "benchmark.tps").string();
+        std::uniform_int_distribution<int32_t> pickCell(0, size * size - 2);
+        double captureTime = 0, worstCaptureTime = 0;
+        for (int i = 0; i < saves; ++i)
+        {
+            // Autosave follows every push, so the writer may still hold the records it dirties
+            int32_t from;
+            do
+                from = pickCell(random);
+            while (board->cells[from] != BoardSnapshot::BlockFlag || board->cells[from + 1] != 0 || (from + 1) % size == 0);
+            const Clock::time_point start = Clock::now();
+            records.push(from, from + 1, (from + 1) % size * 86, (from + 1) / size * 64, 0);
+            std::swap(board->cells[from], board->cells[from + 1]);
+
+            // What GameBoard::captureSaveState does; the pushed block is caught mid-slide
+            SaveState state;
+            state.levelPath = "benchmark.txt";
+            state.board = board;
+            state.objects = records.share([](SaveObject& record)
+            {
+                record.x = (record.x + record.checkpointX) / 2;
+                record.y = (record.y + record.checkpointY) / 2;
+                return true;
+            });
+            state.objectCount = records.size();
+            writer.submit(std::move(state), path);
+            const double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            captureTime += elapsed;
+            worstCaptureTime = std::max(worstCaptureTime, elapsed);
+        }
+
+        Clock::time_point start = Clock::now();
+        writer.flush();
+        const double flushTime = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        start = Clock::now();
+        const SaveFile save(path);
+        int64_t checksum = 0;
+        for (uint32_t i = 0; i < save.getHeader().objectCount; ++i)
+            checksum += save.getObjects()[i].cell;
+        const double loadTime = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        std::cout << std::fixed << std::setprecision(3)
+            << "Save of " << size << "x" << size << " with " << records.size() << " objects, "
+            << std::filesystem::file_size(path) / 1024 << " KiB\n"
+            << "  main thread: " << captureTime / saves << " ms/push and save average, " << worstCaptureTime << " ms worst\n"
+            << "  writer: " << flushTime << " ms to drain after " << saves << " back-to-back saves\n"
+            << "  load: " << loadTime << " ms to map and walk every object (checksum " << checksum << ")\n";
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Save benchmark failed: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,233 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "BoardSnapshot.h"
+#include "MappedFile.h"
+
+/**
+ * @brief On-disk records of a save file. Every section starts 8-byte aligned so a mapped file can be
+ * read in place; fields are little-endian, as on every platform the game ships on.
+ * Layout: SaveHeader, level path, occupancy cells, SaveObject[], SaveCheckpoint[] for the player's
+ * walk, int32_t[] waypoints of the player's hierarchical route.
+ */
+struct SaveHeader
+{
+    char magic[4];
+    uint32_t version;
+    int32_t columns;
+    int32_t rows;
+    uint64_t layoutHash;            // GameBoard::getLayoutHash of the level the save was taken on
+    uint64_t occupancyHash;         // BoardOccupancy::hash, checked against the objects' cells on load
+    uint32_t levelPathLength;
+    uint32_t objectCount;
+    uint32_t playerCheckpointCount;
+    uint32_t routeWaypointCount;
+    uint32_t routeNextSegment;
+    int32_t playerCell;             // BoardSnapshot::playerCell
+    double playerX;
+    double playerY;
+};
+
+struct SaveObject
+{
+    double x;
+    double y;
+    int32_t spawnCell;              // Identifies the object: where the level file places it
+    int32_t cell;                   // Tile it resides on, the end of its walk if it is moving
+    int32_t checkpointX;
+    int32_t checkpointY;
+    uint8_t hasCheckpoint;
+    uint8_t state;                  // SpriteState
+    uint8_t restingState;
+    uint8_t padding[5];
+};
+
+struct SaveCheckpoint
+{
+    int32_t x;
+    int32_t y;
+};
+
+static_assert(sizeof(SaveHeader) == 72 && sizeof(SaveObject) == 40 && sizeof(SaveCheckpoint) == 8,
+    "Save records are written as they are laid out in memory");
+
+/**
+ * @brief The board's SaveObject records, kept current as objects are pushed so a capture copies none of them.
+ * Shared with the writer thread and copied on write like BoardSnapshot, but a page at a time: a push
+ * while a save is being written copies the page table and one page, not every record.
+ */
+class SaveRecords
+{
+public:
+    static constexpr size_t PAGE_SIZE = 1024;                    // Records per page
+
+    using Page = std::vector<SaveObject>;
+    using Pages = std::vector<std::shared_ptr<Page>>;            // Every page full but the last; read-only once shared
+
+    /**
+     * @brief Drops every record, ready for add() on a board of cellCount cells.
+     */
+    void reset(size_t cellCount);
+
+    /**
+     * @brief Adds the record of the object residing on record.cell.
+     */
+    void add(const SaveObject& record);
+
+    /**
+     * @brief Drops the record of the object residing on cell; the last record takes its index.
+     */
+    void remove(int32_t cell);
+
+    /**
+     * @brief The object on fromCell was pushed to toCell and is sliding towards the checkpoint.
+     * Its position is refreshed at the next share(); cells without a record are ignored.
+     */
+    void push(int32_t fromCell, int32_t toCell, int32_t checkpointX, int32_t checkpointY, uint8_t state);
+
+    /**
+     * @brief Refreshes the records pushed since the last call, then shares all of them.
+     * O(pushed objects) however many objects the board holds.
+     * @param refresh updates a record from its object; returns false once the object has come to rest
+     */
+    template <typename Refresh>
+    [[nodiscard]] std::shared_ptr<const Pages> share(Refresh refresh)
+    {
+        std::erase_if(m_sliding, [&](const int32_t index)
+        {
+            SaveObject& record = edit(index);
+            record.hasCheckpoint = refresh(record);
+            return !record.hasCheckpoint;
+        });
+        return m_pages;
+    }
+
+    [[nodiscard]] size_t size() const { return m_size; }
+
+private:
+    SaveObject& edit(int32_t index);
+    Pages& editPages();
+    Page& editPage(size_t page);
+
+    std::shared_ptr<Pages> m_pages = std::make_shared<Pages>();
+    size_t m_size{};
+    std::vector<int32_t> m_recordByCell;                         // Index of the record residing on each cell, -1 if none
+    std::vector<int32_t> m_sliding;                              // Records with hasCheckpoint set, refreshed by share()
+};
+
+/**
+ * @brief Everything a save needs, captured on the main thread and serialized on the writer's.
+ * The occupancy and object records are shared with the board, so capturing them copies nothing.
+ */
+struct SaveState
+{
+    std::string levelPath;
+    uint64_t layoutHash{};
+    uint64_t occupancyHash{};
+    std::shared_ptr<const BoardSnapshot> board;
+    double playerX{};
+    double playerY{};
+    std::shared_ptr<const SaveRecords::Pages> objects;
+    size_t objectCount{};
+    std::vector<SaveCheckpoint> playerCheckpoints;
+    std::vector<int32_t> routeWaypoints;
+    uint32_t routeNextSegment{};
+};
+
+/**
+ * @brief Zero-copy view of a save file; every accessor points into the mapping.
+ */
+class SaveFile
+{
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    /**
+     * @throws std::runtime_error if the file can't be mapped, is truncated or has another version
+     */
+    explicit SaveFile(const std::string& path);
+
+    [[nodiscard]] const SaveHeader& getHeader() const { return *reinterpret_cast<const SaveHeader*>(m_file.data()); }
+    [[nodiscard]] std::string_view getLevelPath() const;
+    [[nodiscard]] const uint8_t* getCells() const { return at<uint8_t>(m_cellsOffset); }
+    [[nodiscard]] const SaveObject* getObjects() const { return at<SaveObject>(m_objectsOffset); }
+    [[nodiscard]] const SaveCheckpoint* getPlayerCheckpoints() const { return at<SaveCheckpoint>(m_checkpointsOffset); }
+    [[nodiscard]] const int32_t* getRouteWaypoints() const { return at<int32_t>(m_waypointsOffset); }
+
+    /**
+     * @brief Section offsets for the counts in a header; the last one is the file size.
+     */
+    struct Layout
+    {
+        size_t levelPath;
+        size_t cells;
+        size_t objects;
+        size_t checkpoints;
+        size_t waypoints;
+        size_t end;
+    };
+    [[nodiscard]] static Layout getLayout(const SaveHeader& header);
+
+private:
+    template <typename T>
+    [[nodiscard]] const T* at(const size_t offset) const { return reinterpret_cast<const T*>(m_file.data() + offset); }
+
+    MappedFile m_file;
+    size_t m_cellsOffset{};
+    size_t m_objectsOffset{};
+    size_t m_checkpointsOffset{};
+    size_t m_waypointsOffset{};
+};
+
+/**
+ * @brief Writes saves on a background thread, under a temporary name renamed into place.
+ * Only the newest pending save is kept: a save submitted while another waits replaces it.
+ */
+class SaveWriter
+{
+public:
+    SaveWriter();
+    ~SaveWriter();
+
+    SaveWriter(const SaveWriter&) = delete;
+    SaveWriter& operator=(const SaveWriter&) = delete;
+
+    void submit(SaveState state, std::string path);
+
+    /**
+     * @brief Blocks until every submitted save is on disk.
+     */
+    void flush();
+
+    /**
+     * @throws std::runtime_error if the file can't be written
+     */
+    static void write(const SaveState& state, const std::string& path);
+
+    /**
+     * @brief Offline tool: times capturing, writing and mapping a 1024x1024 board, pushing a block before
+     * every capture as autosave does.
+     * Run with `TilePuzzle --benchmark-save [directory]`.
+     * @return process exit code
+     */
+    static int runBenchmark(const std::string& directory);
+
+private:
+    void workerLoop();
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::optional<std::pair<SaveState, std::string>> m_pending;
+    bool m_writing{};
+    bool m_stopping{};
+};
@@ -0,0 +1,408 @@
+#include "SectorGraph.h"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+namespace
+{
+    constexpr int DX[] = { 0, -1, 1, 0 };
+    constexpr int DY[] = { -1, 0, 0, 1 };
+
+    thread_local size_t g_lastExpandedCount = 0;
+
+    struct OpenNode
+    {
+        int f{};
+        int g{};
+        int32_t cell{};
+
+        bool operator>(const OpenNode& other) const { return f != other.f ? f > other.f : g < other.g; }
+    };
+}
+
+void SectorGraph::rebuild(const BoardSnapshot& snapshot)
+{
+    m_columns = snapshot.columns;
+    m_rows = snapshot.rows;
+    m_sectorColumns = (m_columns + SECTOR_SIZE - 1) / SECTOR_SIZE;
+    m_sectorRows = (m_rows + SECTOR_SIZE - 1) / SECTOR_SIZE;
+
+    m_blocked.resize(snapshot.cells.size());
+    for (size_t i = 0; i < snapshot.cells.size(); ++i)
+        m_blocked[i] = (snapshot.cells[i] & (BoardSnapshot::WallFlag | BoardSnapshot::BlockFlag)) != 0;
+
+    m_entranceSlots.assign(m_blocked.size(), -1);
+    m_sectors.assign(static_cast<size_t>(m_sectorColumns) * m_sectorRows, {});
+    for (int sector = 0; sector < static_cast<int>(m_sectors.size()); ++sector)
+        rebuildSector(sector);
+}
+
+void SectorGraph::setBlocked(const int32_t cell, const bool blocked)
+{
+    if (isBlocked(cell) == blocked)
+        return;
+    m_blocked[cell] = blocked;
+
+    m_touchedSectors.clear();
+    addTouchedSectors(cell, m_touchedSectors);
+    for (const int sector : m_touchedSectors)
+        rebuildSector(sector);
+}
+
+void SectorGraph::setBlocked(const BoardSnapshot& snapshot, const std::span<const int32_t> cells)
+{
+    m_touchedSectors.clear();
+    for (const int32_t cell : cells)
+    {
+        const bool blocked = (snapshot.cells[cell] & (BoardSnapshot::WallFlag | BoardSnapshot::BlockFlag)) != 0;
+        if (isBlocked(cell) == blocked)
+            continue;
+        m_blocked[cell] = blocked;
+        addTouchedSectors(cell, m_touchedSectors);
+    }
+
+    // Cells sharing a sector rebuild it once
+    std::sort(m_touchedSectors.begin(), m_touchedSectors.end());
+    m_touchedSectors.erase(std::unique(m_touchedSectors.begin(), m_touchedSectors.end()), m_touchedSectors.end());
+    for (const int sector : m_touchedSectors)
+        rebuildSector(sector);
+}
+
+SectorRoute SectorGraph::findRoute(const int32_t start, const int32_t goal) const
+{
+    g_lastExpandedCount = 0;
+    SectorRoute route;
+    const auto cellCount = static_cast<int32_t>(m_blocked.size());
+    if (start < 0 || goal < 0 || start >= cellCount || goal >= cellCount || isBlocked(goal))
+        return route;
+    if (start == goal)
+    {
+        route.waypoints = { start };
+        return route;
+    }
+
+    const int startSector = getSectorIndex(start);
+    const int goalSector = getSectorIndex(goal);
+    const std::vector<int> startDistances = searchSector(start);
+    const std::vector<int> goalDistances = searchSector(goal);
+
+    auto heuristic = [&](const int32_t cell)
+    {
+        return std::abs(cell % m_columns - goal % m_columns) + std::abs(cell / m_columns - goal / m_columns);
+    };
+
+    struct NodeInfo
+    {
+        int g = std::numeric_limits<int>::max();
+        int32_t parent = -1;
+        bool closed{};
+    };
+    std::unordered_map<int32_t, NodeInfo> nodes;
+    std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<>> openList;
+
+    auto relax = [&](const int32_t cell, const int32_t parent, const int g)
+    {
+        NodeInfo& node = nodes[cell];
+        if (g >= node.g)
+            return;
+        node.g = g;
+        node.parent = parent;
+        openList.push({ g + heuristic(cell), g, cell });
+    };
+
+    nodes[start].g = 0;
+    openList.push({ heuristic(start), 0, start });
+
+    while (!openList.empty())
+    {
+        const OpenNode current = openList.top();
+        openList.pop();
+        NodeInfo& node = nodes[current.cell];
+        if (node.closed || current.g > node.g)
+            continue;
+        node.closed = true;
+        ++g_lastExpandedCount;
+
+        if (current.cell == goal)
+        {
+            for (int32_t cell = goal; cell >= 0; cell = nodes[cell].parent)
+                route.waypoints.push_back(cell);
+            std::reverse(route.waypoints.begin(), route.waypoints.end());
+            return route;
+        }
+
+        const int sectorIndex = getSectorIndex(current.cell);
+        const Sector& sector = m_sectors[sectorIndex];
+        const int slot = m_entranceSlots[current.cell];
+
+        // Within the sector: the start and goal aren't in the precomputed table
+        if (current.cell == start)
+        {
+            for (const int32_t entrance : sector.entrances)
+            {
+                const int distance = startDistances[getLocalIndex(entrance)];
+                if (entrance != start && distance >= 0)
+                    relax(entrance, start, distance);
+            }
+            if (startSector == goalSector && startDistances[getLocalIndex(goal)] >= 0)
+                relax(goal, start, startDistances[getLocalIndex(goal)]);
+        }
+        else if (slot >= 0)
+        {
+            const size_t count = sector.entrances.size();
+            for (size_t other = 0; other < count; ++other)
+            {
+                const int distance = sector.distances[slot * count + other];
+                if (other != static_cast<size_t>(slot) && distance >= 0)
+                    relax(sector.entrances[other], current.cell, current.g + distance);
+            }
+            if (sectorIndex == goalSector && goalDistances[getLocalIndex(current.cell)] >= 0)
+                relax(goal, current.cell, current.g + goalDistances[getLocalIndex(current.cell)]);
+        }
+
+        // Across a border to the paired entrance
+        if (slot >= 0)
+        {
+            const int x = current.cell % m_columns;
+            const int y = current.cell / m_columns;
+            for (int direction = 0; direction < 4; ++direction)
+            {
+                const int nextX = x + DX[direction];
+                const int nextY = y + DY[direction];
+                if (!isFree(nextX, nextY))
+                    continue;
+                const int32_t next = nextY * m_columns + nextX;
+                if (m_entranceSlots[next] >= 0 && getSectorIndex(next) != sectorIndex)
+                    relax(next, current.cell, current.g + 1);
+            }
+        }
+    }
+    return route;
+}
+
+std::vector<int32_t> SectorGraph::refineNext(SectorRoute& route) const
+{
+    if (route.isFinished())
+        return {};
+
+    const int32_t from = route.waypoints[route.nextSegment];
+    const int32_t to = route.waypoints[route.nextSegment + 1];
+    std::vector<int32_t> cells;
+    if (route.nextSegment == 0)
+        cells.push_back(from);
+
+    if (getSectorIndex(from) != getSectorIndex(to))
+    {
+        // Border crossings are single steps
+        if (isBlocked(to))
+            return {};
+        cells.push_back(to);
+    }
+    else
+    {
+        std::vector<int32_t> parents;
+        const std::vector<int> distances = searchSector(from, &parents);
+        if (distances[getLocalIndex(to)] < 0)
+            return {};
+
+        const size_t first = cells.size();
+        for (int32_t cell = to; cell != from; cell = parents[getLocalIndex(cell)])
+            cells.push_back(cell);
+        std::reverse(cells.begin() + static_cast<std::ptrdiff_t>(first), cells.end());
+    }
+
+    ++route.nextSegment;
+    return cells;
+}
+
+std::vector<int32_t> SectorGraph::findPath(const int32_t start, const int32_t goal) const
+{
+    SectorRoute route = findRoute(start, goal);
+    if (route.waypoints.size() == 1)
+        return route.waypoints;
+
+    std::vector<int32_t> path;
+    while (!route.isFinished())
+    {
+        const std::vector<int32_t> segment = refineNext(route);
+        if (segment.empty())
+            return {};
+        path.insert(path.end(), segment.begin(), segment.end());
+    }
+    return path;
+}
+
+size_t SectorGraph::getEntranceCount() const
+{
+    size_t count = 0;
+    for (const Sector& sector : m_sectors)
+        count += sector.entrances.size();
+    return count;
+}
+
+size_t SectorGraph::getLastExpandedCount()
+{
+    return g_lastExpandedCount;
+}
+
+int SectorGraph::getSectorIndex(const int32_t cell) const
+{
+    return (cell / m_columns / SECTOR_SIZE) * m_sectorColumns + cell % m_columns / SECTOR_SIZE;
+}
+
+int SectorGraph::getLocalIndex(const int32_t cell) const
+{
+    return (cell / m_columns % SECTOR_SIZE) * SECTOR_SIZE + cell % m_columns % SECTOR_SIZE;
+}
+
+bool SectorGraph::isFree(const int x, const int y) const
+{
+    return x >= 0 && x < m_columns && y >= 0 && y < m_rows && !m_blocked[y * m_columns + x];
+}
+
+void SectorGraph::addTouchedSectors(const int32_t cell, std::vector<int>& sectors) const
+{
+    const int x = cell % m_columns;
+    const int y = cell / m_columns;
+    const int sectorX = x / SECTOR_SIZE;
+    const int sectorY = y / SECTOR_SIZE;
+    sectors.push_back(getSectorIndex(cell));
+
+    // A cell on a border also changes the openings seen from the other side
+    if (x % SECTOR_SIZE == 0 && sectorX > 0)
+        sectors.push_back(sectorY * m_sectorColumns + sectorX - 1);
+    if (x % SECTOR_SIZE == SECTOR_SIZE - 1 && sectorX + 1 < m_sectorColumns)
+        sectors.push_back(sectorY * m_sectorColumns + sectorX + 1);
+    if (y % SECTOR_SIZE == 0 && sectorY > 0)
+        sectors.push_back((sectorY - 1) * m_sectorColumns + sectorX);
+    if (y % SECTOR_SIZE == SECTOR_SIZE - 1 && sectorY + 1 < m_sectorRows)
+        sectors.push_back((sectorY + 1) * m_sectorColumns + sectorX);
+}
+
+void SectorGraph::rebuildSector(const int sector)
+{
+    Sector& target = m_sectors[sector];
+    for (const int32_t entrance : target.entrances)
+        m_entranceSlots[entrance] = -1;
+
+    target.entrances.clear();
+    for (int direction = 0; direction < 4; ++direction)
+        addBorderTransitions(sector, DX[direction], DY[direction], target.entrances);
+
+    // Corner cells can be an entrance on two borders
+    std::sort(target.entrances.begin(), target.entrances.end());
+    target.entrances.erase(std::unique(target.entrances.begin(), target.entrances.end()), target.entrances.end());
+
+    const size_t count = target.entrances.size();
+    for (size_t i = 0; i < count; ++i)
+        m_entranceSlots[target.entrances[i]] = static_cast<int16_t>(i);
+
+    target.distances.assign(count * count, -1);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const std::vector<int> distances = searchSector(target.entrances[i]);
+        for (size_t j = 0; j < count; ++j)
+            target.distances[i * count + j] = distances[getLocalIndex(target.entrances[j])];
+    }
+}
+
+void SectorGraph::addBorderTransitions(const int sector, const int neighborX, const int neighborY, std::vector<int32_t>& entrances) const
+{
+    const int sectorX = sector % m_sectorColumns;
+    const int sectorY = sector / m_sectorColumns;
+    if (sectorX + neighborX < 0 || sectorX + neighborX >= m_sectorColumns ||
+        sectorY + neighborY < 0 || sectorY + neighborY >= m_sectorRows)
+        return;
+
+    const int left = sectorX * SECTOR_SIZE;
+    const int top = sectorY * SECTOR_SIZE;
+    const int right = std::min(left + SECTOR_SIZE, m_columns) - 1;
+    const int bottom = std::min(top + SECTOR_SIZE, m_rows) - 1;
+
+    // Border cells inside this sector, walked in the same order from either side
+    const bool vertical = neighborX != 0;
+    const int length = vertical ? bottom - top + 1 : right - left + 1;
+    auto borderCell = [&](const int i) -> std::pair<int, int>
+    {
+        if (vertical)
+            return { neighborX < 0 ? left : right, top + i };
+        return { left + i, neighborY < 0 ? top : bottom };
+    };
+
+    auto addTransition = [&](const int i)
+    {
+        const auto [x, y] = borderCell(i);
+        entrances.push_back(y * m_columns + x);
+    };
+
+    int runStart = -1;
+    for (int i = 0; i <= length; ++i)
+    {
+        bool open = false;
+        if (i < length)
+        {
+            const auto [x, y] = borderCell(i);
+            open = isFree(x, y) && isFree(x + neighborX, y + neighborY);
+        }
+
+        if (open && runStart < 0)
+            runStart = i;
+        else if (!open && runStart >= 0)
+        {
+            const int runEnd = i - 1;
+            if (runEnd - runStart + 1 < MAX_SINGLE_TRANSITION)
+                addTransition((runStart + runEnd) / 2);
+            else
+            {
+                addTransition(runStart);
+                addTransition(runEnd);
+            }
+            runStart = -1;
+        }
+    }
+}
+
+std::vector<int> SectorGraph::searchSector(const int32_t from, std::vector<int32_t>* parents) const
+{
+    const int sector = getSectorIndex(from);
+    const int left = sector % m_sectorColumns * SECTOR_SIZE;
+    const int top = sector / m_sectorColumns * SECTOR_SIZE;
+    const int right = std::min(left + SECTOR_SIZE, m_columns);
+    const int bottom = std::min(top + SECTOR_SIZE, m_rows);
+
+    std::vector<int> distances(SECTOR_SIZE * SECTOR_SIZE, -1);
+    if (parents)
+        parents->assign(SECTOR_SIZE * SECTOR_SIZE, -1);
+
+    std::vector<int32_t> queue;
+    queue.reserve(SECTOR_SIZE * SECTOR_SIZE);
+    queue.push_back(from);
+    distances[getLocalIndex(from)] = 0;
+
+    for (size_t head = 0; head < queue.size(); ++head)
+    {
+        const int32_t cell = queue[head];
+        const int x = cell % m_columns;
+        const int y = cell / m_columns;
+        for (int direction = 0; direction < 4; ++direction)
+        {
+            const int nextX = x + DX[direction];
+            const int nextY = y + DY[direction];
+            if (nextX < left || nextX >= right || nextY < top || nextY >= bottom || !isFree(nextX, nextY))
+                continue;
+
+            const int32_t next = nextY * m_columns + nextX;
+            int& distance = distances[getLocalIndex(next)];
+            if (distance >= 0)
+                continue;
+            distance = distances[getLocalIndex(cell)] + 1;
+            if (parents)
+                (*parents)[getLocalIndex(next)] = cell;
+            queue.push_back(next);
+        }
+    }
+    return distances;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "BoardSnapshot.h"
+
+/**
+ * @brief Abstract path through the sector graph, refined one segment at a time as it is walked.
+ */
+struct SectorRoute
+{
+    std::vector<int32_t> waypoints;  // Start, the entrances crossed, goal
+    size_t nextSegment{};
+
+    [[nodiscard]] bool empty() const { return waypoints.empty(); }
+    [[nodiscard]] bool isFinished() const { return nextSegment + 1 >= waypoints.size(); }
+    [[nodiscard]] int32_t getGoal() const { return waypoints.back(); }
+};
+
+/**
+ * @brief Hierarchical pathfinding (HPA*) for large boards.
+ * The board is split into SECTOR_SIZE square sectors. Every opening along a border between two
+ * sectors gets one or two transitions, whose cells become entrances, and the walking distance
+ * between each pair of entrances inside a sector is precomputed. A query searches this small graph,
+ * then each segment is refined with a search confined to one sector only when it is about to be
+ * walked. Paths are near-optimal rather than shortest.
+ */
+class SectorGraph
+{
+public:
+    static constexpr int SECTOR_SIZE = 16;
+    static constexpr int MAX_SINGLE_TRANSITION = 6;  // Wider openings get a transition at each end
+
+    /**
+     * @brief Rebuilds every sector; walls and blocks in the snapshot are obstacles.
+     */
+    void rebuild(const BoardSnapshot& snapshot);
+
+    /**
+     * @brief Marks a cell as free or obstructed and rebuilds only the sectors touching it.
+     */
+    void setBlocked(int32_t cell, bool blocked);
+
+    /**
+     * @brief Reads the given cells from the snapshot and rebuilds each sector touching a changed one once.
+     */
+    void setBlocked(const BoardSnapshot& snapshot, std::span<const int32_t> cells);
+
+    /**
+     * @return abstract route from start to goal, empty if the goal can't be reached
+     */
+    [[nodiscard]] SectorRoute findRoute(int32_t start, int32_t goal) const;
+
+    /**
+     * @brief Refines the route's next segment against the current board and advances it.
+     * The first segment includes the start cell.
+     * @return cells to walk, empty if the segment has been blocked since the route was planned
+     */
+    [[nodiscard]] std::vector<int32_t> refineNext(SectorRoute& route) const;
+
+    /**
+     * @return every cell from start to goal inclusive, refined all at once
+     */
+    [[nodiscard]] std::vector<int32_t> findPath(int32_t start, int32_t goal) const;
+
+    [[nodiscard]] bool isBlocked(const int32_t cell) const { return m_blocked[cell] != 0; }
+    [[nodiscard]] size_t getEntranceCount() const;
+
+    /**
+     * @brief Abstract nodes expanded by the last findRoute on this thread, for benchmarks.
+     */
+    [[nodiscard]] static size_t getLastExpandedCount();
+
+private:
+    struct Sector
+    {
+        std::vector<int32_t> entrances;
+        std::vector<int> distances;   // entrances.size() squared, -1 if unreachable within the sector
+    };
+
+    [[nodiscard]] int getSectorIndex(int32_t cell) const;
+    [[nodiscard]] bool isFree(int x, int y) const;
+    void addTouchedSectors(int32_t cell, std::vector<int>& sectors) const;
+    void rebuildSector(int sector);
+    void addBorderTransitions(int sector, int neighborX, int neighborY, std::vector<int32_t>& entrances) const;
+
+    /**
+     * @brief Breadth-first search confined to the sector holding from.
+     * @param parents optional, filled with each cell's predecessor
+     * @return distance to every cell of the sector by local index, -1 if unreachable
+     */
+    std::vector<int> searchSector(int32_t from, std::vector<int32_t>* parents = nullptr) const;
+    [[nodiscard]] int getLocalIndex(int32_t cell) const;
+
+    int m_columns{};
+    int m_rows{};
+    int m_sectorColumns{};
+    int m_sectorRows{};
+    std::vector<uint8_t> m_blocked;        // y * columns + x
+    std::vector<Sector> m_sectors;
+    std::vector<int16_t> m_entranceSlots;  // Index into the cell's sector entrances, -1 if not an entrance
+    std::vector<int> m_touchedSectors;     // Scratch for setBlocked
+};
@@ -0,0 +1,143 @@
+#include "SpriteAtlas.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include "AssetCache.h"
+
+AtlasLayout readAtlasLayout(std::istream& stream, const std::string& sourceName)
+{
+    AtlasLayout layout;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(stream, line))
+    {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty())
+            continue;
+
+        std::istringstream record(line);
+        std::string type;
+        record >> type;
+
+        const auto fail = [&](const std::string& reason)
+        {
+            return std::runtime_error(sourceName + ":" + std::to_string(lineNumber) + ": " + reason);
+        };
+
+        if (type == "page")
+        {
+            size_t index;
+            std::string file;
+            if (!(record >> index >> file) || index != layout.pages.size())
+                throw fail("malformed page record");
+            layout.pages.push_back(file);
+        }
+        else if (type == "sprite")
+        {
+            std::string name;
+            size_t state;
+            AtlasLayout::Region region;
+            if (!(record >> name >> state >> region.page >> region.rect.x >> region.rect.y >> region.rect.w >> region.rect.h))
+                throw fail("malformed sprite record");
+            if (state >= SPRITE_STATE_COUNT || region.page < 0 || static_cast<size_t>(region.page) >= layout.pages.size())
+                throw fail("sprite record out of range");
+            layout.sprites[name][state] = region;
+        }
+        else
+        {
+            throw fail("unknown record '" + type + "'");
+        }
+    }
+    return layout;
+}
+
+void writeAtlasLayout(std::ostream& stream, const AtlasLayout& layout)
+{
+    for (size_t i = 0; i < layout.pages.size(); ++i)
+        stream << "page " << i << " " << layout.pages[i] << "\n";
+
+    for (const auto& [name, regions] : layout.sprites)
+    {
+        for (size_t state = 0; state < SPRITE_STATE_COUNT; ++state)
+        {
+            const auto& [page, rect] = regions[state];
+            stream << "sprite " << name << " " << state << " " << page << " "
+                << rect.x << " " << rect.y << " " << rect.w << " " << rect.h << "\n";
+        }
+    }
+}
+
+std::string getAtlasSpriteName(const std::string& path)
+{
+    return std::filesystem::path(path).stem().string();
+}
+
+SpriteAtlas& SpriteAtlas::getInstance()
+{
+    static SpriteAtlas instance;
+    return instance;
+}
+
+bool SpriteAtlas::load(const std::string& metadataPath, SDL_Renderer* renderer)
+{
+    std::ifstream file(metadataPath);
+    if (!file)
+        return false;
+
+    AtlasLayout layout = readAtlasLayout(file, metadataPath);
+    const std::filesystem::path directory = std::filesystem::path(metadataPath).parent_path();
+
+    std::vector<TextureResidency::Handle> pages;
+    TextureResidency& residency = TextureResidency::getInstance();
+    try
+    {
+        for (const std::string& page : layout.pages)
+        {
+            // Uploads read straight from the mapped cache entry
+            pages.push_back(residency.add(renderer, AssetCache::getInstance().createView((directory / page).string())));
+        }
+    }
+    catch (...)
+    {
+        for (const TextureResidency::Handle handle : pages)
+            residency.release(handle);
+        throw;
+    }
+
+    unload();
+    m_renderer = renderer;
+    m_layout = std::move(layout);
+    m_pages = std::move(pages);
+    return true;
+}
+
+void SpriteAtlas::unload()
+{
+    for (const TextureResidency::Handle handle : m_pages)
+        TextureResidency::getInstance().release(handle);
+    m_pages.clear();
+    m_layout = {};
+    m_renderer = nullptr;
+}
+
+bool SpriteAtlas::find(const std::string& path, SDL_Renderer* renderer,
+    std::array<TextureResidency::Handle, SPRITE_STATE_COUNT>& textures,
+    std::array<SDL_Rect, SPRITE_STATE_COUNT>& regions) const
+{
+    if (renderer != m_renderer)
+        return false;
+
+    const auto it = m_layout.sprites.find(getAtlasSpriteName(path));
+    if (it == m_layout.sprites.end())
+        return false;
+
+    for (size_t state = 0; state < SPRITE_STATE_COUNT; ++state)
+    {
+        textures[state] = m_pages[it->second[state].page];
+        regions[state] = it->second[state].rect;
+    }
+    return true;
+}
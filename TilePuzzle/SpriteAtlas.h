@@ -0,0 +1,78 @@
+#pragma once
+#include <array>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <map>
+#include <vector>
+#include <SDL.h>
+#include "SpriteState.h"
+#include "TextureResidency.h"
+
+/**
+ * @brief Name-to-rect table of a packed atlas, as written by AtlasPacker.
+ * Every sprite has one rect per SpriteState; all of a sprite's states live on the same page.
+ *
+ * Text format, one record per line:
+ *   page <index> <file name relative to the table>
+ *   sprite <name> <state index> <page> <x> <y> <w> <h>
+ */
+struct AtlasLayout
+{
+    struct Region
+    {
+        int page{};
+        SDL_Rect rect{};
+    };
+
+    using StateRegions = std::array<Region, SPRITE_STATE_COUNT>;
+
+    std::vector<std::string> pages;
+    std::map<std::string, StateRegions> sprites;
+};
+
+AtlasLayout readAtlasLayout(std::istream& stream, const std::string& sourceName);
+void writeAtlasLayout(std::ostream& stream, const AtlasLayout& layout);
+
+/**
+ * @return atlas name of the sprite stored at path, i.e. its file name without extension
+ */
+std::string getAtlasSpriteName(const std::string& path);
+
+/**
+ * @brief Atlas pages uploaded for one renderer. Sprites whose asset is in the atlas draw sub-rects
+ * of a shared page texture, so consecutive draws don't switch textures and SDL can batch them.
+ */
+class SpriteAtlas
+{
+public:
+    static constexpr const char* DEFAULT_PATH = "./sprites/atlas/atlas.txt";
+
+    static SpriteAtlas& getInstance();
+
+    /**
+     * @return false if there is no atlas at metadataPath; sprites then fall back to their own files
+     */
+    bool load(const std::string& metadataPath, SDL_Renderer* renderer);
+    void unload();
+
+    /**
+     * @param texture set to the page holding the sprite
+     * @param regions set to the sprite's source rect per state
+     * @return false if the sprite at path isn't in the atlas loaded for renderer
+     */
+    bool find(const std::string& path, SDL_Renderer* renderer,
+        std::array<TextureResidency::Handle, SPRITE_STATE_COUNT>& textures,
+        std::array<SDL_Rect, SPRITE_STATE_COUNT>& regions) const;
+
+    SpriteAtlas(const SpriteAtlas&) = delete;
+    SpriteAtlas& operator=(const SpriteAtlas&) = delete;
+
+private:
+    SpriteAtlas() = default;
+    ~SpriteAtlas() { unload(); }
+
+    SDL_Renderer* m_renderer{};
+    AtlasLayout m_layout;
+    std::vector<TextureResidency::Handle> m_pages;
+};
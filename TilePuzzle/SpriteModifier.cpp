@@ -0,0 +1,47 @@
+#include "SpriteModifier.h"
+
+SDL_Color SpriteModifier::toSdlColor() const
+{
+    return
+    {
+        colorClamp(r),
+        colorClamp(g),
+        colorClamp(b),
+        colorClamp(a)
+    };
+}
+
+void SpriteModifier::applyTo(SDL_Surface* surface) const
+{
+    // Lock surface to access pixel data
+    if (SDL_LockSurface(surface) != 0)
+        return;
+
+    auto* pixels = static_cast<uint32_t*>(surface->pixels); // Access pixel data
+
+    const int width = surface->w;
+    const int height = surface->h;
+
+    // Manipulate each pixel
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const uint32_t pixel = pixels[y * width + x];
+            uint8_t red, green, blue, alpha;
+            SDL_GetRGBA(pixel, surface->format, &red, &green, &blue, &alpha);
+
+            // Apply offset and colorClamp operation to each color component
+            red = colorClamp(red + r);
+            green = colorClamp(green + g);
+            blue = colorClamp(blue + b);
+            alpha = colorClamp(alpha + a);
+
+            // Update pixel
+            pixels[y * width + x] = SDL_MapRGBA(surface->format, red, green, blue, alpha);
+        }
+    }
+
+    // Unlock surface
+    SDL_UnlockSurface(surface);
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include <SDL.h>
+
+/**
+ * @brief Struct to perform offset operations on SDL_Colors
+ */
+struct SpriteModifier
+{
+    SpriteModifier(const std::string& description, const int r, const int g, const int b, const int a)
+        : name(description), r(r), g(g), b(b), a(a) {}
+
+    SpriteModifier() = default;
+
+    SpriteModifier(const std::string& description, const SDL_Color& other)
+        : name(description), r(other.r), g(other.g), b(other.b), a(other.a) {}
+
+    static constexpr uint8_t colorClamp(const int value)
+    {
+        return static_cast<uint8_t>(value > 255 ? 255 : (value < 0 ? 0 : value));
+    }
+
+    // Returns a properly clamped SDL_Color.
+    SDL_Color toSdlColor() const;
+
+    // Offsets every pixel of a 32-bit surface in place.
+    void applyTo(SDL_Surface* surface) const;
+
+    std::string name;
+    int r{}, g{}, b{}, a{};
+};
+
+inline std::ostream& operator<<(std::ostream& os, const SpriteModifier& color)
+{
+    os << "{" << color.r << ", " << color.g << ", " << color.b << ", " << color.a << "}";
+    return os;
+}
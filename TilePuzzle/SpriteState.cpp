@@ -0,0 +1,94 @@
+#include "SpriteState.h"
+#include "SDLExceptions.h"
+#include "SpriteAtlas.h"
+#include "AssetCache.h"
+
+const SpriteModifier& getStateModifier(const SpriteState state)
+{
+    static const std::array<SpriteModifier, SPRITE_STATE_COUNT> modifiers =
+    {
+        SpriteModifier{ "Idle", 0, 0, 0, 0 },
+        SpriteModifier{ "Hovered", 30, 30, 30, 0 },
+        SpriteModifier{ "Selected", 50, 50, 0, 0 },
+        SpriteModifier{ "GoalFilled", -30, 40, -30, 0 },
+        SpriteModifier{ "Pushed", -40, -40, -40, 0 }
+    };
+    return modifiers[static_cast<size_t>(state)];
+}
+
+StateTextures::StateTextures(SDL_Surface* source, SDL_Renderer* renderer)
+{
+    TextureResidency& residency = TextureResidency::getInstance();
+    try
+    {
+        for (size_t i = 0; i < SPRITE_STATE_COUNT; ++i)
+        {
+            // Already in the cache's format, so this is a plain copy for the modifier to work on
+            SDL_Surface* surface = SDL_ConvertSurfaceFormat(source, AssetCache::getInstance().getPixelFormat(), 0);
+            if (!surface)
+                throw SDLImageLoadException(SDL_GetError());
+
+            getStateModifier(static_cast<SpriteState>(i)).applyTo(surface);
+            m_textures[i] = residency.add(renderer, surface);
+        }
+    }
+    catch (...)
+    {
+        for (const TextureResidency::Handle handle : m_textures)
+            residency.release(handle);
+        throw;
+    }
+}
+
+StateTextures::StateTextures(const Handles& atlasPages, const Regions& regions)
+    : m_textures(atlasPages), m_regions(regions), m_isAtlas(true)
+{}
+
+StateTextures::~StateTextures()
+{
+    if (m_isAtlas)
+        return;
+
+    for (const TextureResidency::Handle handle : m_textures)
+        TextureResidency::getInstance().release(handle);
+}
+
+StateTextureCache& StateTextureCache::getInstance()
+{
+    static StateTextureCache instance;
+    return instance;
+}
+
+std::shared_ptr<const StateTextures> StateTextureCache::acquire(const std::string& path, SDL_Renderer* renderer)
+{
+    StateTextureCache& instance = getInstance();
+    std::weak_ptr<const StateTextures>& entry = instance.m_entries[{ renderer, path }];
+    if (auto textures = entry.lock())
+        return textures;
+
+    StateTextures::Handles atlasPages;
+    StateTextures::Regions regions;
+    if (SpriteAtlas::getInstance().find(path, renderer, atlasPages, regions))
+    {
+        auto textures = std::make_shared<const StateTextures>(atlasPages, regions);
+        entry = textures;
+        return textures;
+    }
+
+    SDL_Surface* source = AssetCache::getInstance().createView(path);
+
+    std::shared_ptr<const StateTextures> textures;
+    try
+    {
+        textures = std::make_shared<const StateTextures>(source, renderer);
+    }
+    catch (...)
+    {
+        SDL_FreeSurface(source);
+        throw;
+    }
+    SDL_FreeSurface(source);
+
+    entry = textures;
+    return textures;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <array>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <SDL.h>
+#include "SpriteModifier.h"
+#include "TextureResidency.h"
+
+enum class SpriteState : uint8_t
+{
+    Idle = 0,
+    Hovered,
+    Selected,
+    GoalFilled,
+    Pushed,
+    Count
+};
+
+constexpr size_t SPRITE_STATE_COUNT = static_cast<size_t>(SpriteState::Count);
+
+/**
+ * @return colour offset baked into the texture of the given state
+ */
+const SpriteModifier& getStateModifier(SpriteState state);
+
+/**
+ * @brief One texture per SpriteState, baked from a single asset when it is first requested.
+ * The baked surfaces are retained by TextureResidency, so unused states can be evicted.
+ * Assets found in the SpriteAtlas instead point at pre-baked regions of a shared atlas page.
+ */
+class StateTextures
+{
+public:
+    using Handles = std::array<TextureResidency::Handle, SPRITE_STATE_COUNT>;
+    using Regions = std::array<SDL_Rect, SPRITE_STATE_COUNT>;
+
+    StateTextures(SDL_Surface* source, SDL_Renderer* renderer);
+
+    /**
+     * @brief Borrows atlas pages; the atlas keeps ownership of the textures.
+     */
+    StateTextures(const Handles& atlasPages, const Regions& regions);
+    ~StateTextures();
+
+    StateTextures(const StateTextures&) = delete;
+    StateTextures& operator=(const StateTextures&) = delete;
+
+    [[nodiscard]] SDL_Texture* get(const SpriteState state) const
+    {
+        return TextureResidency::getInstance().acquire(m_textures[static_cast<size_t>(state)]);
+    }
+
+    /**
+     * @return part of get(state) to draw, or nullptr for the whole texture
+     */
+    [[nodiscard]] const SDL_Rect* getSourceRect(const SpriteState state) const
+    {
+        return m_isAtlas ? &m_regions[static_cast<size_t>(state)] : nullptr;
+    }
+
+private:
+    Handles m_textures{};
+    Regions m_regions{};
+    bool m_isAtlas = false;
+};
+
+/**
+ * @brief Shares baked state textures between every sprite created from the same asset.
+ * Entries are held weakly, so textures are released together with the last sprite using them.
+ */
+class StateTextureCache
+{
+public:
+    static std::shared_ptr<const StateTextures> acquire(const std::string& path, SDL_Renderer* renderer);
+
+    StateTextureCache(const StateTextureCache&) = delete;
+    StateTextureCache& operator=(const StateTextureCache&) = delete;
+
+private:
+    StateTextureCache() = default;
+    static StateTextureCache& getInstance();
+
+    std::map<std::pair<SDL_Renderer*, std::string>, std::weak_ptr<const StateTextures>> m_entries;
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+using AssetId = uint16_t;
+
+/**
+ * @brief Keys whose ids are fixed at compile time, in id order, so embedded levels can store ids.
+ * AssetRegistry interns them before anything in the manifest, which gives them their textures.
+ */
+inline constexpr std::array<std::string_view, 4> TEXTURE_KEYS = { "Empty", "Grass", "Rock", "Goal" };
+
+inline constexpr AssetId EMPTY_ASSET = 0;
+
+/**
+ * @return id of the key, or TEXTURE_KEYS.size() if it is not one of them
+ */
+[[nodiscard]] constexpr size_t findTextureId(const std::string_view key)
+{
+    for (size_t id = 0; id < TEXTURE_KEYS.size(); ++id)
+    {
+        if (TEXTURE_KEYS[id] == key)
+            return id;
+    }
+    return TEXTURE_KEYS.size();
+}
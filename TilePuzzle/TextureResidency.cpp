@@ -0,0 +1,130 @@
+#include "TextureResidency.h"
+#include <algorithm>
+#include "SDLExceptions.h"
+
+TextureResidency& TextureResidency::getInstance()
+{
+    static TextureResidency instance;
+    return instance;
+}
+
+TextureResidency::Handle TextureResidency::add(SDL_Renderer* renderer, SDL_Surface* surface)
+{
+    if (!surface)
+        throw SDLImageLoadException("Cannot register a null surface");
+
+    Handle handle;
+    if (!m_freeHandles.empty())
+    {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    }
+    else
+    {
+        handle = static_cast<Handle>(m_entries.size());
+        m_entries.emplace_back();
+    }
+
+    Entry& entry = m_entries[handle];
+    entry.renderer = renderer;
+    entry.surface = surface;
+    entry.texture = nullptr;
+    entry.bytes = static_cast<size_t>(surface->w) * surface->h * 4;
+    entry.lastUsedFrame = m_frame;
+    m_statistics.retainedBytes += static_cast<size_t>(surface->pitch) * surface->h;
+
+    if (!upload(entry, handle))
+    {
+        release(handle);
+        throw SDLImageLoadException(SDL_GetError());
+    }
+    ++m_statistics.uploads;
+    evictToBudget();
+    return handle;
+}
+
+void TextureResidency::release(const Handle handle)
+{
+    if (handle == INVALID_HANDLE || handle >= m_entries.size() || !m_entries[handle].surface)
+        return;
+
+    Entry& entry = m_entries[handle];
+    evict(entry);
+    m_statistics.retainedBytes -= static_cast<size_t>(entry.surface->pitch) * entry.surface->h;
+    SDL_FreeSurface(entry.surface);
+    entry = Entry{};
+    m_freeHandles.push_back(handle);
+}
+
+SDL_Texture* TextureResidency::acquire(const Handle handle)
+{
+    if (handle == INVALID_HANDLE || handle >= m_entries.size())
+        return nullptr;
+
+    Entry& entry = m_entries[handle];
+    if (!entry.surface)
+        return nullptr;
+
+    entry.lastUsedFrame = m_frame;
+    if (entry.texture)
+    {
+        m_lru.splice(m_lru.begin(), m_lru, entry.lruPosition);
+        return entry.texture;
+    }
+
+    if (!upload(entry, handle))
+        return nullptr;
+    ++m_statistics.reuploads;
+    evictToBudget();
+    return entry.texture;
+}
+
+void TextureResidency::beginFrame()
+{
+    ++m_frame;
+    evictToBudget();
+}
+
+void TextureResidency::setBudget(const size_t bytes)
+{
+    m_budgetBytes = bytes;
+    evictToBudget();
+}
+
+bool TextureResidency::upload(Entry& entry, const Handle handle)
+{
+    entry.texture = SDL_CreateTextureFromSurface(entry.renderer, entry.surface);
+    if (!entry.texture)
+        return false;
+
+    m_lru.push_front(handle);
+    entry.lruPosition = m_lru.begin();
+    m_statistics.residentBytes += entry.bytes;
+    m_statistics.peakResidentBytes = std::max(m_statistics.peakResidentBytes, m_statistics.residentBytes);
+    return true;
+}
+
+void TextureResidency::evict(Entry& entry)
+{
+    if (!entry.texture)
+        return;
+
+    SDL_DestroyTexture(entry.texture);
+    entry.texture = nullptr;
+    m_lru.erase(entry.lruPosition);
+    m_statistics.residentBytes -= entry.bytes;
+}
+
+void TextureResidency::evictToBudget()
+{
+    // Textures drawn this frame are never evicted, even if that leaves us over budget
+    while (m_statistics.residentBytes > m_budgetBytes && !m_lru.empty())
+    {
+        Entry& entry = m_entries[m_lru.back()];
+        if (entry.lastUsedFrame >= m_frame)
+            break;
+
+        evict(entry);
+        ++m_statistics.evictions;
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <vector>
+#include <SDL.h>
+
+/**
+ * @brief Keeps cached textures within a byte budget.
+ * Every texture is registered together with the surface it was created from; when the budget is
+ * exceeded, textures that were not drawn this frame are evicted least-recently-used first and
+ * re-uploaded from the retained surface the next time they are acquired.
+ * Not thread-safe: acquire from one thread at a time.
+ */
+class TextureResidency
+{
+public:
+    using Handle = uint32_t;
+    static constexpr Handle INVALID_HANDLE = 0;
+    static constexpr size_t DEFAULT_BUDGET_BYTES = 256ull * 1024 * 1024;
+
+    struct Statistics
+    {
+        size_t residentBytes{};
+        size_t peakResidentBytes{};
+        size_t retainedBytes{};
+        uint64_t uploads{};
+        uint64_t reuploads{};
+        uint64_t evictions{};
+    };
+
+    static TextureResidency& getInstance();
+
+    /**
+     * @param surface surface to create the texture from; ownership is taken
+     */
+    Handle add(SDL_Renderer* renderer, SDL_Surface* surface);
+    void release(Handle handle);
+
+    /**
+     * @brief Marks the texture as used this frame, re-uploading it if it was evicted.
+     */
+    SDL_Texture* acquire(Handle handle);
+
+    /**
+     * @brief Starts a new frame and evicts down to the budget.
+     */
+    void beginFrame();
+
+    void setBudget(size_t bytes);
+    [[nodiscard]] size_t getBudget() const { return m_budgetBytes; }
+    [[nodiscard]] const Statistics& getStatistics() const { return m_statistics; }
+
+    TextureResidency(const TextureResidency&) = delete;
+    TextureResidency& operator=(const TextureResidency&) = delete;
+
+private:
+    TextureResidency() = default;
+    ~TextureResidency() = default;
+
+    struct Entry
+    {
+        SDL_Renderer* renderer{};
+        SDL_Surface* surface{};
+        SDL_Texture* texture{};
+        size_t bytes{};
+        uint64_t lastUsedFrame{};
+        std::list<Handle>::iterator lruPosition{};
+    };
+
+    bool upload(Entry& entry, Handle handle);
+    void evict(Entry& entry);
+    void evictToBudget();
+
+    std::vector<Entry> m_entries{ Entry{} }; // Slot 0 backs INVALID_HANDLE
+    std::vector<Handle> m_freeHandles;
+    std::list<Handle> m_lru;                 // Resident textures, most recently used first
+    size_t m_budgetBytes = DEFAULT_BUDGET_BYTES;
+    uint64_t m_frame = 1;
+    Statistics m_statistics;
+};
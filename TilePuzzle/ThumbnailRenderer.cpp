@@ -0,0 +1,296 @@
+#include "ThumbnailRenderer.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include "AssetCache.h"
+#include "AssetRegistry.h"
+#include "BoardGeometry.h"
+#include "EmbeddedLevels.h"
+#include "SDLExceptions.h"
+#include "WorkerPool.h"
+
+ThumbnailRenderer::ThumbnailRenderer(const double scale)
+{
+    if (!(scale > 0.0 && scale <= MAX_SCALE))
+        throw std::invalid_argument("Thumbnail scale must be above 0 and at most " + std::to_string(static_cast<int>(MAX_SCALE)));
+
+    // Whole-pixel tiles keep the grid free of seams; sprites scale by the rounded size
+    m_tileWidth = std::max(1, static_cast<int>(std::lround(TileGeometry::TILE_DIMENSIONS.x * scale)));
+    m_tileHeight = std::max(1, static_cast<int>(std::lround(TileGeometry::TILE_DIMENSIONS.y * scale)));
+    m_scaleX = static_cast<double>(m_tileWidth) / TileGeometry::TILE_DIMENSIONS.x;
+    m_scaleY = static_cast<double>(m_tileHeight) / TileGeometry::TILE_DIMENSIONS.y;
+
+    const AssetRegistry& registry = AssetRegistry::getInstance();
+    m_sprites.resize(registry.size());
+    m_filledGoals.resize(registry.size());
+    for (size_t id = 0; id < registry.size(); ++id)
+    {
+        const AssetRegistry::Asset& asset = registry.get(static_cast<AssetId>(id));
+        if (asset.texturePath.empty())
+            continue;
+
+        m_sprites[id] = loadSprite(asset.texturePath, SpriteState::Idle);
+        if (asset.flags & AssetRegistry::GoalAsset)
+            m_filledGoals[id] = loadSprite(asset.texturePath, SpriteState::GoalFilled);
+    }
+}
+
+ThumbnailRenderer::ScaledSprite ThumbnailRenderer::loadSprite(const std::string& path, const SpriteState state) const
+{
+    SDL_Surface* decoded = AssetCache::getInstance().createSurface(path);
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(decoded, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(decoded);
+    if (!surface)
+        throw SDLImageLoadException(SDL_GetError());
+
+    // Same modifier the game bakes into its state textures
+    getStateModifier(state).applyTo(surface);
+
+    ScaledSprite sprite;
+    sprite.w = std::max(1, static_cast<int>(std::lround(surface->w * m_scaleX)));
+    sprite.h = std::max(1, static_cast<int>(std::lround(surface->h * m_scaleY)));
+    sprite.pixels.resize(static_cast<size_t>(sprite.w) * sprite.h);
+    sprite.opaque = true;
+
+    // Each output pixel averages the source pixels it covers, or repeats the nearest one when enlarging.
+    // Premultiplying keeps transparent pixels' colour from bleeding into the edges.
+    const auto* source = static_cast<const uint8_t*>(surface->pixels);
+    for (int y = 0; y < sprite.h; ++y)
+    {
+        const int top = static_cast<int>(static_cast<int64_t>(y) * surface->h / sprite.h);
+        const int bottom = std::max(top + 1, static_cast<int>(static_cast<int64_t>(y + 1) * surface->h / sprite.h));
+        for (int x = 0; x < sprite.w; ++x)
+        {
+            const int left = static_cast<int>(static_cast<int64_t>(x) * surface->w / sprite.w);
+            const int right = std::max(left + 1, static_cast<int>(static_cast<int64_t>(x + 1) * surface->w / sprite.w));
+
+            uint64_t alpha = 0, red = 0, green = 0, blue = 0;
+            for (int sourceY = top; sourceY < bottom; ++sourceY)
+            {
+                const auto* row = reinterpret_cast<const uint32_t*>(source + static_cast<size_t>(sourceY) * surface->pitch);
+                for (int sourceX = left; sourceX < right; ++sourceX)
+                {
+                    const uint32_t pixel = row[sourceX];
+                    const uint32_t a = pixel >> 24;
+                    alpha += a;
+                    red += ((pixel >> 16) & 0xFF) * a;
+                    green += ((pixel >> 8) & 0xFF) * a;
+                    blue += (pixel & 0xFF) * a;
+                }
+            }
+
+            const uint64_t count = static_cast<uint64_t>(bottom - top) * (right - left);
+            uint32_t pixel = 0;
+            if (alpha)
+            {
+                pixel = static_cast<uint32_t>((alpha + count / 2) / count) << 24 |
+                    static_cast<uint32_t>((red + alpha / 2) / alpha) << 16 |
+                    static_cast<uint32_t>((green + alpha / 2) / alpha) << 8 |
+                    static_cast<uint32_t>((blue + alpha / 2) / alpha);
+            }
+            sprite.opaque &= (pixel >> 24) == 0xFF;
+            sprite.pixels[static_cast<size_t>(y) * sprite.w + x] = pixel;
+        }
+    }
+
+    SDL_FreeSurface(surface);
+    return sprite;
+}
+
+void ThumbnailRenderer::draw(const ScaledSprite& sprite, const int left, const int top, Image& image)
+{
+    const int firstX = std::max(0, -left);
+    const int firstY = std::max(0, -top);
+    const int lastX = std::min(sprite.w, image.w - left);
+    const int lastY = std::min(sprite.h, image.h - top);
+    if (firstX >= lastX || firstY >= lastY)
+        return;
+
+    for (int y = firstY; y < lastY; ++y)
+    {
+        const uint32_t* source = &sprite.pixels[static_cast<size_t>(y) * sprite.w + firstX];
+        uint32_t* destination = &image.pixels[static_cast<size_t>(top + y) * image.w + left + firstX];
+        const int count = lastX - firstX;
+        if (sprite.opaque)
+        {
+            std::memcpy(destination, source, static_cast<size_t>(count) * sizeof(uint32_t));
+            continue;
+        }
+
+        // Source over destination, both with straight alpha
+        for (int x = 0; x < count; ++x)
+        {
+            const uint32_t sourceAlpha = source[x] >> 24;
+            const uint32_t destinationAlpha = destination[x] >> 24;
+            if (sourceAlpha == 0)
+                continue;
+            if (sourceAlpha == 0xFF || destinationAlpha == 0)
+            {
+                destination[x] = source[x];
+                continue;
+            }
+
+            const uint32_t sourceWeight = sourceAlpha * 0xFF;
+            const uint32_t destinationWeight = destinationAlpha * (0xFF - sourceAlpha);
+            const uint32_t total = sourceWeight + destinationWeight;
+            uint32_t pixel = ((total + 0x7F) / 0xFF) << 24;
+            for (const int shift : { 16, 8, 0 })
+            {
+                const uint32_t channel = (((source[x] >> shift) & 0xFF) * sourceWeight +
+                    ((destination[x] >> shift) & 0xFF) * destinationWeight + total / 2) / total;
+                pixel |= channel << shift;
+            }
+            destination[x] = pixel;
+        }
+    }
+}
+
+void ThumbnailRenderer::render(const LevelLayers& layers, Image& image) const
+{
+    // File rows run along x, as on the board
+    image.w = layers.rows * m_tileWidth;
+    image.h = layers.columns * m_tileHeight;
+    image.pixels.assign(static_cast<size_t>(image.w) * image.h, 0);
+
+    const AssetRegistry& registry = AssetRegistry::getInstance();
+    for (int x = 0; x < layers.rows; ++x)
+    {
+        for (int y = 0; y < layers.columns; ++y)
+        {
+            // Any resident object fills a goal, as in Tile::setResidingEntity
+            const size_t cell = layers.index(x, y);
+            const AssetId tile = layers.tiles[cell];
+            const bool occupied = layers.immovables[cell] != EMPTY_ASSET || layers.movables[cell] != EMPTY_ASSET;
+            draw(occupied && registry.isGoal(tile) ? m_filledGoals[tile] : m_sprites[tile], x * m_tileWidth, y * m_tileHeight, image);
+        }
+    }
+
+    // Objects after every tile, since they may overhang their cell; the movable layer wins as in GameBoard
+    for (int x = 0; x < layers.rows; ++x)
+    {
+        for (int y = 0; y < layers.columns; ++y)
+        {
+            const size_t cell = layers.index(x, y);
+            const AssetId object = layers.movables[cell] != EMPTY_ASSET ? layers.movables[cell] : layers.immovables[cell];
+            if (object != EMPTY_ASSET)
+                draw(m_sprites[object], x * m_tileWidth, y * m_tileHeight, image);
+        }
+    }
+}
+
+void ThumbnailRenderer::savePng(const Image& image, const std::string& path)
+{
+    // IMG_SavePNG only reads the pixels
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint32_t*>(image.pixels.data()),
+        image.w, image.h, 32, image.w * static_cast<int>(sizeof(uint32_t)), SDL_PIXELFORMAT_ARGB8888);
+    if (!surface)
+        throw SDLImageLoadException(SDL_GetError());
+
+    const bool saved = IMG_SavePNG(surface, path.c_str()) == 0;
+    SDL_FreeSurface(surface);
+    if (!saved)
+        throw SDLImageLoadException(SDL_GetError());
+}
+
+int ThumbnailRenderer::run(const std::vector<std::string>& arguments)
+{
+    std::vector<std::string> inputs;
+    std::string outputDirectory = DEFAULT_OUTPUT;
+    double scale = DEFAULT_SCALE;
+    try
+    {
+        for (size_t i = 0; i < arguments.size(); ++i)
+        {
+            if (arguments[i] == "--output" && i + 1 < arguments.size())
+                outputDirectory = arguments[++i];
+            else if (arguments[i] == "--scale" && i + 1 < arguments.size())
+                scale = std::stod(arguments[++i]);
+            else
+                inputs.push_back(arguments[i]);
+        }
+    }
+    catch (const std::logic_error&)
+    {
+        inputs.clear();
+    }
+    if (inputs.empty())
+    {
+        std::cerr << "Usage: TilePuzzle --render-thumbnails <file or directory>... [--output directory] [--scale factor]\n";
+        return 2;
+    }
+
+    // Sprites are decoded on this thread; workers only read them
+    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
+    {
+        std::cerr << "Couldn't initialize SDL_image: " << SDL_GetError() << "\n";
+        return 2;
+    }
+
+    std::vector<LevelFile> files;
+    std::vector<std::string> outputs;
+    std::unique_ptr<ThumbnailRenderer> renderer;
+    try
+    {
+        renderer = std::make_unique<ThumbnailRenderer>(scale);
+        files = findLevelFiles(inputs);
+        for (const LevelFile& file : files)
+        {
+            std::filesystem::path output = std::filesystem::path(outputDirectory) / file.name;
+            output.replace_extension(".png");
+            std::filesystem::create_directories(output.parent_path());
+            outputs.push_back(output.string());
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Couldn't start rendering thumbnails: " << e.what() << "\n";
+        IMG_Quit();
+        return 2;
+    }
+
+    // Workers take the next level as they finish one, so large boards don't hold up a whole chunk
+    const auto start = std::chrono::steady_clock::now();
+    WorkerPool pool;
+    std::vector<std::string> failures(files.size());
+    std::atomic<size_t> next{ 0 };
+    pool.parallelFor(pool.size(), [&](size_t, size_t, unsigned)
+    {
+        Image image;
+        for (size_t i = next++; i < files.size(); i = next++)
+        {
+            try
+            {
+                renderer->render(loadLevelLayers(files[i].path, EmbeddedLevels::MAX_ROWS, EmbeddedLevels::MAX_COLUMNS), image);
+                savePng(image, outputs[i]);
+            }
+            catch (const std::exception& e)
+            {
+                failures[i] = e.what();
+            }
+        }
+    });
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    IMG_Quit();
+
+    size_t failed = 0;
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        if (failures[i].empty())
+            continue;
+        std::cerr << files[i].path << ": " << failures[i] << "\n";
+        ++failed;
+    }
+
+    std::cout << "Rendered " << files.size() - failed << " of " << files.size() << " thumbnails with "
+        << renderer->getTileWidth() << "x" << renderer->getTileHeight() << " tiles in " << std::fixed << std::setprecision(1)
+        << elapsed << " ms on " << pool.size() << " threads into " << outputDirectory << "\n";
+    return failed ? 1 : 0;
+}
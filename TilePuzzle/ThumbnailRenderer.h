@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <SDL.h>
+#include "LevelData.h"
+#include "SpriteState.h"
+
+/**
+ * @brief Offline tool: renders previews of levels for the level-select screen and writes them as PNGs.
+ * Run with `TilePuzzle --render-thumbnails <file or directory>... [--output directory] [--scale factor]`.
+ * Boards are composited in software into plain ARGB8888 buffers, so no window or renderer is needed.
+ * Each asset is decoded and scaled once up front; levels are then rendered and compressed in parallel.
+ */
+class ThumbnailRenderer
+{
+public:
+    static constexpr const char* DEFAULT_OUTPUT = "./thumbnails";
+    static constexpr double DEFAULT_SCALE = 0.25;
+    static constexpr double MAX_SCALE = 4.0;
+
+    /**
+     * @brief Straight-alpha ARGB8888 pixels, row by row without padding.
+     */
+    struct Image
+    {
+        int w{};
+        int h{};
+        std::vector<uint32_t> pixels;
+    };
+
+    /**
+     * @param scale thumbnail size relative to the board on screen; tiles are rounded to whole pixels
+     * @throws std::runtime_error or SDLImageLoadException if a texture can't be loaded
+     */
+    explicit ThumbnailRenderer(double scale);
+
+    /**
+     * @brief Draws the board as it looks when the level starts, player aside. Safe to call from many threads.
+     * @param image reused between calls to keep its allocation
+     */
+    void render(const LevelLayers& layers, Image& image) const;
+
+    [[nodiscard]] int getTileWidth() const { return m_tileWidth; }
+    [[nodiscard]] int getTileHeight() const { return m_tileHeight; }
+
+    /**
+     * @throws SDLImageLoadException if the file can't be written
+     */
+    static void savePng(const Image& image, const std::string& path);
+
+    /**
+     * @return process exit code: 0 if every level was rendered, 1 if any failed, 2 for bad arguments
+     */
+    static int run(const std::vector<std::string>& arguments);
+
+private:
+    struct ScaledSprite
+    {
+        int w{};
+        int h{};
+        bool opaque{};                                           // Every pixel has full alpha, so rows can be copied
+        std::vector<uint32_t> pixels;
+    };
+
+    /**
+     * @brief Box-filters the texture's pixels in the given state, averaging with premultiplied alpha.
+     */
+    [[nodiscard]] ScaledSprite loadSprite(const std::string& path, SpriteState state) const;
+
+    static void draw(const ScaledSprite& sprite, int left, int top, Image& image);
+
+    int m_tileWidth{};
+    int m_tileHeight{};
+    double m_scaleX{};
+    double m_scaleY{};
+    std::vector<ScaledSprite> m_sprites;                         // By asset id; empty for assets without a texture
+    std::vector<ScaledSprite> m_filledGoals;                     // By asset id, goal tiles only: the GoalFilled state
+};
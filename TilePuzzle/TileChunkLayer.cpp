@@ -0,0 +1,184 @@
+#include "TileChunkLayer.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "RenderStatistics.h"
+
+TileChunkLayer::~TileChunkLayer()
+{
+    destroyChunks();
+}
+
+void TileChunkLayer::setTiles(const DynamicBoard& tiles)
+{
+    destroyChunks();
+    m_tiles = tiles;
+    m_queued.assign(m_tiles.size(), false);
+
+    const int chunkColumns = (m_tiles.columns() + CHUNK_TILES - 1) / CHUNK_TILES;
+    const int chunkRows = (m_tiles.rows() + CHUNK_TILES - 1) / CHUNK_TILES;
+    m_chunks.resize(chunkColumns, chunkRows);
+
+    for (int y = 0; y < chunkRows; ++y)
+    {
+        for (int x = 0; x < chunkColumns; ++x)
+        {
+            // Edge chunks only cover the tiles that exist
+            const Vector2<int> first = { x * CHUNK_TILES, y * CHUNK_TILES };
+            const Vector2<int> last = { std::min(first.x + CHUNK_TILES, m_tiles.columns()), std::min(first.y + CHUNK_TILES, m_tiles.rows()) };
+            const Vector2<int> origin = TileGeometry::toScreenCoordinates(first);
+            const Vector2<int> extent = TileGeometry::toScreenCoordinates(last) - origin;
+            m_chunks.at(x, y).worldRect = { origin.x, origin.y, extent.x, extent.y };
+        }
+    }
+}
+
+void TileChunkLayer::setTile(const int x, const int y, const std::shared_ptr<Tile>& tile)
+{
+    if (!m_tiles.contains(x, y))
+        return;
+
+    m_tiles.at(x, y) = tile;
+    markDirty(x, y);
+}
+
+void TileChunkLayer::markDirty(const int x, const int y)
+{
+    if (!m_tiles.contains(x, y))
+        return;
+
+    const size_t cell = static_cast<size_t>(y) * m_tiles.columns() + x;
+    Chunk& chunk = m_chunks.at(x / CHUNK_TILES, y / CHUNK_TILES);
+    if (chunk.dirty || m_queued[cell])
+        return;
+
+    m_queued[cell] = true;
+    chunk.dirtyCells.push_back({ x, y });
+}
+
+void TileChunkLayer::invalidate()
+{
+    for (Chunk& chunk : m_chunks)
+        chunk.dirty = true;
+}
+
+void TileChunkLayer::render(const Camera& camera)
+{
+    m_chunksDrawn = 0;
+    if (m_chunks.size() == 0)
+        return;
+
+    const SDL_Rect visibleRect = camera.getVisibleRect();
+    const Vector2<int> chunkPixels = TileGeometry::toScreenCoordinates({ CHUNK_TILES, CHUNK_TILES });
+    const int firstX = std::max(0, visibleRect.x / chunkPixels.x);
+    const int firstY = std::max(0, visibleRect.y / chunkPixels.y);
+    const int lastX = std::min(m_chunks.columns() - 1, (visibleRect.x + visibleRect.w) / chunkPixels.x);
+    const int lastY = std::min(m_chunks.rows() - 1, (visibleRect.y + visibleRect.h) / chunkPixels.y);
+
+    for (int y = firstY; y <= lastY; ++y)
+    {
+        for (int x = firstX; x <= lastX; ++x)
+        {
+            Chunk& chunk = m_chunks.at(x, y);
+            if (SDL_HasIntersection(&visibleRect, &chunk.worldRect) != SDL_TRUE)
+                continue;
+
+            if (chunk.dirty)
+                compose(chunk);
+            else if (!chunk.dirtyCells.empty())
+                recompose(chunk);
+
+            const SDL_Rect screenRect = camera.worldToScreen(chunk.worldRect);
+            RenderStatistics::copy(m_renderer, chunk.texture, nullptr, &screenRect);
+            ++m_chunksDrawn;
+        }
+    }
+}
+
+void TileChunkLayer::compose(Chunk& chunk)
+{
+    if (!chunk.texture)
+    {
+        chunk.texture = SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+            chunk.worldRect.w, chunk.worldRect.h);
+        if (!chunk.texture)
+            throw std::runtime_error(std::string("Failed to create tile chunk texture: ") + SDL_GetError());
+        SDL_SetTextureBlendMode(chunk.texture, SDL_BLENDMODE_BLEND);
+    }
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(m_renderer);
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(m_renderer, &r, &g, &b, &a);
+
+    SDL_SetRenderTarget(m_renderer, chunk.texture);
+    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 0);
+    SDL_RenderClear(m_renderer);
+
+    const Vector2<int> first = TileGeometry::toBoardCoordinates({ chunk.worldRect.x, chunk.worldRect.y });
+    const Vector2<int> last = TileGeometry::toBoardCoordinates({ chunk.worldRect.x + chunk.worldRect.w - 1, chunk.worldRect.y + chunk.worldRect.h - 1 });
+    for (int y = first.y; y <= last.y; ++y)
+    {
+        for (int x = first.x; x <= last.x; ++x)
+            drawTile(x, y, chunk.worldRect);
+    }
+
+    SDL_SetRenderTarget(m_renderer, previousTarget);
+    SDL_SetRenderDrawColor(m_renderer, r, g, b, a);
+
+    // A full compose covers whatever was queued
+    for (const Vector2<int>& cell : chunk.dirtyCells)
+        m_queued[static_cast<size_t>(cell.y) * m_tiles.columns() + cell.x] = false;
+    chunk.dirtyCells.clear();
+    chunk.dirty = false;
+}
+
+void TileChunkLayer::recompose(Chunk& chunk)
+{
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(m_renderer);
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(m_renderer, &r, &g, &b, &a);
+    SDL_BlendMode blendMode;
+    SDL_GetRenderDrawBlendMode(m_renderer, &blendMode);
+
+    SDL_SetRenderTarget(m_renderer, chunk.texture);
+    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 0);
+
+    for (const Vector2<int>& cell : chunk.dirtyCells)
+    {
+        // Overwrite the cell with transparency instead of blending over what was there
+        const Vector2<int> origin = TileGeometry::toScreenCoordinates(cell);
+        const SDL_Rect cellRect = { origin.x - chunk.worldRect.x, origin.y - chunk.worldRect.y, Tile::TILE_DIMENSIONS.x, Tile::TILE_DIMENSIONS.y };
+        SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_NONE);
+        SDL_RenderFillRect(m_renderer, &cellRect);
+        SDL_SetRenderDrawBlendMode(m_renderer, blendMode);
+
+        drawTile(cell.x, cell.y, chunk.worldRect);
+        m_queued[static_cast<size_t>(cell.y) * m_tiles.columns() + cell.x] = false;
+    }
+    chunk.dirtyCells.clear();
+
+    SDL_SetRenderTarget(m_renderer, previousTarget);
+    SDL_SetRenderDrawColor(m_renderer, r, g, b, a);
+}
+
+void TileChunkLayer::drawTile(const int x, const int y, const SDL_Rect& chunkRect) const
+{
+    const std::shared_ptr<Tile>& tile = m_tiles.at(x, y);
+    if (!tile || !tile->getRenderFlag())
+        return;
+
+    SDL_Rect rect = tile->getSdlRect();
+    rect.x -= chunkRect.x;
+    rect.y -= chunkRect.y;
+    RenderStatistics::copy(m_renderer, tile->getCachedTexture(), tile->getSourceRect(), &rect);
+}
+
+void TileChunkLayer::destroyChunks()
+{
+    for (Chunk& chunk : m_chunks)
+    {
+        if (chunk.texture)
+            SDL_DestroyTexture(chunk.texture);
+        chunk.texture = nullptr;
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <SDL.h>
+#include "Camera.h"
+#include "GameBoard.h"
+#include "TileGrid.h"
+
+/**
+ * @brief Draws the tile board as CHUNK_TILES x CHUNK_TILES blocks pre-composited into target textures.
+ * Only chunks intersecting the camera are drawn, one copy each. Tiles whose appearance changed are
+ * reported with markDirty and composited again cell by cell the next time their chunk is visible.
+ */
+class TileChunkLayer
+{
+public:
+    static constexpr int CHUNK_TILES = 32;
+
+    explicit TileChunkLayer(SDL_Renderer* renderer) : m_renderer(renderer) {}
+    ~TileChunkLayer();
+    TileChunkLayer(const TileChunkLayer&) = delete;
+    TileChunkLayer& operator=(const TileChunkLayer&) = delete;
+
+    /**
+     * @brief Takes the board's current tiles; every chunk is composed again on its next draw.
+     */
+    void setTiles(const DynamicBoard& tiles);
+
+    /**
+     * @brief Swaps in a tile the board replaced in place, e.g. on a same-size reload, and queues it.
+     */
+    void setTile(int x, int y, const std::shared_ptr<Tile>& tile);
+
+    /**
+     * @brief Queues the tile at (x, y) to be composited again, e.g. after a hover or a goal fill.
+     */
+    void markDirty(int x, int y);
+
+    /**
+     * @brief Forces every chunk to be composed again, e.g. after the renderer lost its targets.
+     */
+    void invalidate();
+    void render(const Camera& camera);
+
+    [[nodiscard]] size_t getChunksDrawn() const { return m_chunksDrawn; }
+
+private:
+    struct Chunk
+    {
+        SDL_Texture* texture{};
+        SDL_Rect worldRect{};
+        bool dirty = true;                                       // Whole chunk needs composing
+        std::vector<Vector2<int>> dirtyCells;
+    };
+
+    void compose(Chunk& chunk);
+    void recompose(Chunk& chunk);
+    void drawTile(int x, int y, const SDL_Rect& chunkRect) const;
+    void destroyChunks();
+
+    SDL_Renderer* m_renderer;
+    DynamicBoard m_tiles;
+    std::vector<bool> m_queued;                                  // Cells already waiting in a chunk's dirtyCells
+    TileGrid<Chunk> m_chunks;
+    size_t m_chunksDrawn{};
+};
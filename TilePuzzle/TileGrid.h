@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * @brief Row-major 2D cell storage addressed as (x, y), sized when a board is read.
+ */
+template <typename T>
+class TileGrid
+{
+public:
+    TileGrid() = default;
+    TileGrid(const int columns, const int rows) { resize(columns, rows); }
+
+    void resize(const int columns, const int rows)
+    {
+        m_columns = columns;
+        m_rows = rows;
+        m_cells.assign(static_cast<size_t>(columns) * rows, T{});
+    }
+
+    [[nodiscard]] int columns() const { return m_columns; }
+    [[nodiscard]] int rows() const { return m_rows; }
+    [[nodiscard]] size_t size() const { return m_cells.size(); }
+
+    [[nodiscard]] bool contains(const int x, const int y) const
+    {
+        return static_cast<unsigned>(x) < static_cast<unsigned>(m_columns) &&
+               static_cast<unsigned>(y) < static_cast<unsigned>(m_rows);
+    }
+
+    T& at(const int x, const int y) { return m_cells[index(x, y)]; }
+    const T& at(const int x, const int y) const { return m_cells[index(x, y)]; }
+
+    auto begin() { return m_cells.begin(); }
+    auto end() { return m_cells.end(); }
+    auto begin() const { return m_cells.begin(); }
+    auto end() const { return m_cells.end(); }
+
+private:
+    [[nodiscard]] size_t index(const int x, const int y) const { return static_cast<size_t>(y) * m_columns + x; }
+    int m_columns{};
+    int m_rows{};
+    std::vector<T> m_cells;
+};
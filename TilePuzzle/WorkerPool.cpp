@@ -0,0 +1,94 @@
+#include "WorkerPool.h"
+#include <algorithm>
+#include <utility>
+
+WorkerPool::WorkerPool(const unsigned threadCount) : m_threadCount(std::max(1u, threadCount))
+{
+    m_threads.reserve(m_threadCount - 1);
+    for (unsigned worker = 1; worker < m_threadCount; ++worker)
+        m_threads.emplace_back(&WorkerPool::workerLoop, this, worker);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+void WorkerPool::parallelFor(const size_t count, const ChunkTask& task)
+{
+    if (count == 0)
+        return;
+
+    const auto chunks = static_cast<unsigned>(std::min<size_t>(m_threadCount, count));
+    if (chunks == 1)
+    {
+        task(0, count, 0);
+        return;
+    }
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_task = &task;
+        m_count = count;
+        m_chunks = chunks;
+        m_pending = chunks - 1;
+        m_error = nullptr;
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    runChunk(0);
+
+    std::unique_lock lock(m_mutex);
+    m_done.wait(lock, [this] { return m_pending == 0; });
+    m_task = nullptr;
+    if (m_error)
+        std::rethrow_exception(std::exchange(m_error, nullptr));
+}
+
+void WorkerPool::workerLoop(const unsigned worker)
+{
+    uint64_t seenGeneration = 0;
+    while (true)
+    {
+        {
+            std::unique_lock lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_generation != seenGeneration; });
+            seenGeneration = m_generation;
+            if (m_stopping)
+                return;
+            if (worker >= m_chunks)
+                continue;
+        }
+
+        runChunk(worker);
+
+        std::lock_guard lock(m_mutex);
+        if (--m_pending == 0)
+            m_done.notify_one();
+    }
+}
+
+void WorkerPool::runChunk(const unsigned worker)
+{
+    const size_t begin = m_count * worker / m_chunks;
+    const size_t end = m_count * (worker + 1) / m_chunks;
+    try
+    {
+        (*m_task)(begin, end, worker);
+    }
+    catch (...)
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_error)
+            m_error = std::current_exception();
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Persistent threads for data-parallel loops.
+ * The calling thread takes part in every loop, so a pool of size 1 runs everything inline.
+ */
+class WorkerPool
+{
+public:
+    using ChunkTask = std::function<void(size_t begin, size_t end, unsigned worker)>;
+
+    explicit WorkerPool(unsigned threadCount = std::thread::hardware_concurrency());
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief Splits [0, count) into one contiguous chunk per worker and blocks until all are done.
+     * The first exception thrown by a chunk is rethrown here.
+     */
+    void parallelFor(size_t count, const ChunkTask& task);
+
+    [[nodiscard]] unsigned size() const { return m_threadCount; }
+
+private:
+    void workerLoop(unsigned worker);
+    void runChunk(unsigned worker);
+
+    unsigned m_threadCount;
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const ChunkTask* m_task{};
+    size_t m_count{};
+    unsigned m_chunks{};
+    unsigned m_pending{};
+    uint64_t m_generation{};
+    bool m_stopping{};
+    std::exception_ptr m_error;
+};
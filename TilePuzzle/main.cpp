@@ -1,26 +1,56 @@
 #include "WindowLoader.h"
+#include "AtlasPacker.h"
+#include "PathBenchmark.h"
+#include "SaveGame.h"
+#include "LevelValidator.h"
+#include "ThumbnailRenderer.h"
+#include "AllocationTracker.h"
 #include <iostream>
-
-// TODO: Each sprite should have multiple states it can exist as, and each of those should be cached.
-// TODO: That way, they can easily switch from one to another.
+#include <string>
 
 int main(int argc, char** argv)
 {
+    // Before anything touches SDL's allocator
+    AllocationTracker::install();
+
+    // Offline tools
+    if (argc > 1 && std::string(argv[1]) == "--pack-atlas")
+    {
+        return AtlasPacker::run(
+            argc > 2 ? argv[2] : AtlasPacker::DEFAULT_SOURCE,
+            argc > 3 ? argv[3] : AtlasPacker::DEFAULT_OUTPUT);
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--benchmark-paths")
+        return PathBenchmark::run(argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 1);
+
+    if (argc > 1 && std::string(argv[1]) == "--validate-levels")
+        return LevelValidator::run({ argv + 2, argv + argc });
+
+    if (argc > 1 && std::string(argv[1]) == "--render-thumbnails")
+        return ThumbnailRenderer::run({ argv + 2, argv + argc });
+
+    if (argc > 1 && std::string(argv[1]) == "--benchmark-save")
+        return SaveWriter::runBenchmark(argc > 2 ? argv[2] : "./saves");
+
+    if (argc > 1 && std::string(argv[1]) == "--assert-steady-allocations")
+    {
+        if (!AllocationTracker::ENABLED)
+            std::cerr << "--assert-steady-allocations needs a build with TILEPUZZLE_TRACK_ALLOCATIONS\n";
+        AllocationTracker::setSteadyStateAssertion(true);
+    }
+
     WindowLoader loader;
 
-    //if (argc > 1)
-    //{
-    //    // Load the specified level
-    //    std::string levelPath = argv[1];
-    //    loader.loadBoard(levelPath);
-    //}
-    //else
-    //{
-    //    // Load start menu
-    //    loader.loadStartScreen();
-    //}
-
-    loader.loadBoard("start.txt");
+    // A level file after the flags is played with hot reload; otherwise the built-in start level
+    std::string levelPath = "builtin:start";
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::string(argv[i]).starts_with("--"))
+            levelPath = argv[i];
+    }
+
+    loader.loadBoard(levelPath);
 
     return 0;
 }